@@ -7,103 +7,443 @@
 #include "ui.h"
 #include "can_bus.h"
 #include "sdlog.h"
+#include "rollup.h"
+#include "signal_store.h"
+#include "glyph_cache.h"
 #include "touch_integration.h"
+#include "n2k_fastpacket.h"
+#include "pgn_dispatch.h"
+#include "boot_sched.h"
+#include "perf_hud.h"
+#include "perf_trace.h"
+#include "console.h"
+#include "lvgl_indev_compat.h"
+#include "esp_heap_caps.h"
+#include <atomic>
 
 #if defined(LVGL_VERSION_MAJOR) && (LVGL_VERSION_MAJOR >= 9)
 #error "This project targets LVGL v8.x only. Please install the LVGL 8.x library and remove LVGL 9."
 #endif
 
 static lv_disp_t* g_disp = nullptr;
+static lv_indev_t* g_indev = nullptr;
 static bool g_sd_ok = false;
-static SeriesRuntime s1h, s6h, s24h;
+static RollupSignal g_batt_v;
+static RollupSignal g_wind_speed;
+// Set by the storage boot phase (release) once the rollups are built; the
+// decoders and tasks read it with acquire before touching them.
+static std::atomic<bool> g_history_ready{false};
+static N2kFastPacket g_fastpacket;
+
+// SD mount and history warm start; no LVGL calls.
+static void boot_storage(void*) {
+  g_sd_ok = sdlog_begin();
+  // 1024 buckets per tier: 1h @3.5s, 6h @21s, 24h @84s
+  static const SeriesConfig tiers[] = {
+    { "1h",  1024, 3500  },
+    { "6h",  1024, 21000 },
+    { "24h", 1024, 84000 },
+  };
+  rollup_init(g_batt_v,     "battery_v", tiers, 3, g_sd_ok);
+  rollup_init(g_wind_speed, "wind_ms",   tiers, 3, g_sd_ok);
+  if (g_sd_ok) {
+    rollup_restore(g_batt_v);
+    rollup_restore(g_wind_speed);
+  }
+  g_history_ready.store(true, std::memory_order_release);
+}
+
+static TaskHandle_t g_render_task = nullptr;
+static TaskHandle_t g_data_task = nullptr;
+static bool g_can_polled = false;   // no ingest task: the data task polls the UART
+// Render task wake reasons (task notification bits)
+enum : uint32_t { WAKE_TOUCH = 1u << 0, WAKE_DATA = 1u << 1, WAKE_CONSOLE = 1u << 2 };
+
+// Min spacing of render passes woken by new data; render task only.
+static uint16_t g_render_period_ms = RENDER_PERIOD_MS;
+
+// Render-task changes asked for by the console; the render task applies them.
+static struct {
+  volatile int8_t   hud = -1, touch_dot = -1;   // -1 = leave as is
+  volatile uint16_t refr_ms = 0, indev_ms = 0;  // 0 = leave as is
+  volatile bool     perf_reset = false;
+} g_ui_req;
+static void start_tasks();
+static void console_start();
+
+static BootPhase g_boot_touch   = { "touch",   [](void*) { touch_hw_init(); }, nullptr };
+static BootPhase g_boot_storage = { "storage", boot_storage, nullptr };
 
 void setup() {
   Serial.begin(115200);
   delay(200);
+  boot_mark("setup");
+
+  // Independent of the panel: start them first so they overlap with it
+  boot_start(g_boot_touch);
+  boot_start(g_boot_storage);
 
   // Initializes LVGL inside
   g_disp = display_port_init();
+  boot_mark("display up");
 
   ui_build();
-  touch_init_and_register();
+  g_indev = touch_register_indev();
   touch_debug_overlay_enable(false);
+  perf_hud_enable(PERF_HUD_AT_BOOT);
+  lv_refr_now(g_disp);
+  boot_mark("first frame");
 
-  g_sd_ok = sdlog_begin();
-  if (g_sd_ok) {
-    sdlog_open_series("battery_v_1h");
-    sdlog_open_series("battery_v_6h");
-    sdlog_open_series("battery_v_24h");
+  n2k_fp_init(g_fastpacket);
+  CANBRIDGE_UART.setRxBufferSize(CANBRIDGE_RX_BUF);
+  CANBRIDGE_UART.begin(CANBRIDGE_BAUD, SERIAL_8N1, CANBRIDGE_RX, CANBRIDGE_TX);
+  if (!canbridge_start_task(CANBRIDGE_UART)) {
+    Serial.println("[CAN] ingest task failed; data task polls the UART");
+    canbridge_begin(CANBRIDGE_UART);
+    g_can_polled = true;
   }
-  // 1h @3.5s raw, 6h avg@21s, 24h avg@84s
-  series_init(s1h,  { "1h",  1024, 3500  });
-  series_init(s6h,  { "6h",  1024, 21000 });
-  series_init(s24h, { "24h", 1024, 84000 });
+  boot_mark("can bridge up");
 
-  CANBRIDGE_UART.begin(CANBRIDGE_BAUD, SERIAL_8N1, CANBRIDGE_RX, CANBRIDGE_TX);
-  canbridge_begin(CANBRIDGE_UART);
+  // From here on only the render task touches LVGL
+  start_tasks();
+  canbridge_set_consumer(g_data_task);
+  touch_set_waker(g_render_task, WAKE_TOUCH);
+  console_start();
+}
+
+static int64_t rd_i64(const uint8_t* d) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--) v = (v << 8) | d[i];
+  return (int64_t)v;
+}
+
+static void pgn_battery_status(uint8_t src, const uint8_t* d, uint16_t len) {
+  uint16_t mv = (uint16_t)d[2] | ((uint16_t)d[3] << 8);
+  float v = mv / 100.0f;
+  signal_set(SIG_BATT_V, v);
+  if (g_history_ready.load(std::memory_order_acquire)) rollup_add(g_batt_v, millis(), v);
+}
+
+static void pgn_wind(uint8_t src, const uint8_t* d, uint16_t len) {
+  uint16_t sp = (uint16_t)d[1] | ((uint16_t)d[2] << 8);
+  uint16_t ar = (uint16_t)d[3] | ((uint16_t)d[4] << 8);
+  float speed_ms = sp * 0.01f;
+  float angle_rad = ar * 0.0001f;
+  signal_set(SIG_WIND_SPEED, speed_ms);
+  signal_set(SIG_WIND_ANGLE, angle_rad);
+  if (g_history_ready.load(std::memory_order_acquire)) rollup_add(g_wind_speed, millis(), speed_ms);
+}
+
+static void pgn_gnss_position(uint8_t src, const uint8_t* d, uint16_t len) {
+  int64_t lat = rd_i64(d + 7), lon = rd_i64(d + 15);
+  if (lat == INT64_MAX || lon == INT64_MAX) return;   // no fix
+  signal_set(SIG_GNSS_LAT, (float)(lat * 1e-16));
+  signal_set(SIG_GNSS_LON, (float)(lon * 1e-16));
+}
+
+static void pgn_gnss_sats(uint8_t src, const uint8_t* d, uint16_t len) {
+  if (d[2] != 0xFF) signal_set(SIG_GNSS_SATS, d[2]);
 }
 
-static float    filt_acc    = 0;
-static uint32_t filt_count  = 0;
-static uint32_t last_avg_ms = 0;
+// Devices that announced themselves, for the console's "pgn" listing.
+// Written by the data task only; a listing racing an update may show a torn name.
+#define N2K_DEVICE_SLOTS 16
+static struct N2kDevice { bool used; uint8_t src; uint16_t product; char model[33]; } g_devices[N2K_DEVICE_SLOTS];
+
+static void pgn_product_info(uint8_t src, const uint8_t* d, uint16_t len) {
+  N2kDevice* dev = nullptr;
+  for (N2kDevice& e : g_devices) {
+    if (e.used && e.src == src) { dev = &e; break; }
+    if (!e.used && !dev) dev = &e;
+  }
+  if (!dev) return;   // table full; keep the first ones seen
+  dev->src = src;
+  dev->product = (uint16_t)d[2] | ((uint16_t)d[3] << 8);
+  memcpy(dev->model, d + 4, 32); dev->model[32] = 0;
+  for (int i = 31; i >= 0 && (dev->model[i] == ' ' || dev->model[i] == '@' || (uint8_t)dev->model[i] == 0xFF); i--)
+    dev->model[i] = 0;
+  dev->used = true;
+}
 
-static void handle_pgn(uint32_t pgn, const uint8_t* d, uint8_t len) {
-  if (pgn == 127508 && len >= 5) {                 // Battery Status (Voltage)
-    uint16_t mv = (uint16_t)d[2] | ((uint16_t)d[3] << 8);
-    float v = mv / 100.0f;
-    ui_update_batt_v(v);
+// Every PGN we decode. Add a row here to route a new PGN; order does not matter.
+static constexpr PgnRoute kPgnRoutes[] = {
+  //  PGN    min_len  fast-packet  decoder
+  { 127508,  5,       false,       pgn_battery_status },  // Battery Status
+  { 130306,  5,       false,       pgn_wind           },  // Wind Data
+  { 129029,  23,      true,        pgn_gnss_position  },  // GNSS Position Data
+  { 129540,  3,       true,        pgn_gnss_sats      },  // GNSS Satellites in View
+  { 126996,  36,      true,        pgn_product_info   },  // Product Information
+};
+static_assert(pgn_routes_unique(kPgnRoutes), "PGN registered twice in kPgnRoutes");
+static constexpr PgnDispatch<sizeof(kPgnRoutes) / sizeof(kPgnRoutes[0])> g_pgn_table(kPgnRoutes);
+
+// Messages decoded per route; written by the data task only.
+static uint32_t g_pgn_count[g_pgn_table.size()];
+static uint32_t g_pgn_unrouted = 0;   // frames with no route
+
+static void handle_frame(const CanFrame& f) {
+  uint32_t pgn = n2k_pgn(f.id);
+  int i = g_pgn_table.index_of(pgn);
+  if (i < 0) { g_pgn_unrouted++; return; }
+  const PgnRoute* r = &g_pgn_table.route(i);
+  uint8_t src = n2k_src(f.id);
+  if (r->fast_packet) {
+    N2kMessage m;
+    if (n2k_fp_feed(g_fastpacket, pgn, src, f.data, f.len, millis(), m) && m.len >= r->min_len) {
+      g_pgn_count[i]++;
+      r->decode(m.src, m.data, m.len);
+    }
+  } else if (f.len >= r->min_len) {
+    g_pgn_count[i]++;
+    r->decode(src, f.data, f.len);
+  }
+}
 
+static void apply_ui_requests() {
+  int8_t on;
+  uint16_t ms;
+  if ((on = g_ui_req.hud) >= 0)       { g_ui_req.hud = -1;       perf_hud_enable(on); }
+  if ((on = g_ui_req.touch_dot) >= 0) { g_ui_req.touch_dot = -1; touch_debug_overlay_enable(on); }
+  if ((ms = g_ui_req.refr_ms))        { g_ui_req.refr_ms = 0;    g_render_period_ms = ms; }
+  if ((ms = g_ui_req.indev_ms))       { g_ui_req.indev_ms = 0;   lvgl_set_indev_read_period(g_indev, ms); }
+  if (g_ui_req.perf_reset)            { g_ui_req.perf_reset = false; perf_trace_reset(); }
+}
+
+// Owns LVGL. Sleeps until touch input, new data or LVGL's next timer
+// deadline (the value lv_timer_handler() returns), whichever comes first.
+static void render_task(void*) {
+  uint32_t last = millis();
+  uint32_t last_pass = 0;
+  uint32_t wait_ms = 0;
+  lv_timer_t* refr = _lv_disp_get_refr_timer(g_disp);
+  for (;;) {
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &bits, pdMS_TO_TICKS(wait_ms));
     uint32_t now = millis();
-    if (series_maybe_store(s1h, now, v)) sdlog_append_csv("battery_v_1h", now, v);
-
-    // Aggregate for 6h/24h series
-    filt_acc += v; filt_count++;
-    if (now - last_avg_ms >= 21000) {
-      float avg = (filt_count ? (filt_acc / filt_count) : v);
-      series_maybe_store(s6h, now, avg); sdlog_append_csv("battery_v_6h", now, avg);
-
-      static uint32_t last_24 = 0;
-      static float acc24 = 0; static uint32_t cnt24 = 0;
-      acc24 += avg; cnt24++;
-      if (now - last_24 >= 84000) {
-        float avg24 = cnt24 ? (acc24 / cnt24) : avg;
-        series_maybe_store(s24h, now, avg24);
-        sdlog_append_csv("battery_v_24h", now, avg24);
-        last_24 = now; acc24 = 0; cnt24 = 0;
-      }
-      last_avg_ms = now; filt_acc = 0; filt_count = 0;
+    // Coalesce data bursts; touch, console and LVGL deadlines run right away
+    if ((bits & WAKE_DATA) && !(bits & WAKE_TOUCH) && now - last_pass < g_render_period_ms) {
+      vTaskDelay(pdMS_TO_TICKS(g_render_period_ms - (now - last_pass)));
+      now = millis();
+    }
+    last_pass = now;
+#if !defined(LV_TICK_CUSTOM) || (LV_TICK_CUSTOM == 0)
+    lv_tick_inc(now - last);   // LVGL 8 API when using the built-in tick
+#endif
+    last = now;
+
+    if (bits & WAKE_TOUCH) touch_indev_wake();
+    if (bits & WAKE_CONSOLE) apply_ui_requests();
+    if (g_history_ready.load(std::memory_order_acquire)) {
+      static bool bound = false;
+      if (!bound) { bound = true; ui_bind_battery_history(g_batt_v.tiers, g_batt_v.tier_count); }
+    }
+    ui_tick();            // pull changed signals; invalidates what changed
+    // The refresh timer runs only while something is invalid or animating,
+    // so an idle screen sleeps until the next real deadline or event
+    bool parked = refr && g_disp->inv_p == 0 && lv_anim_count_running() == 0;
+    if (refr && !parked) lv_timer_resume(refr);
+    {
+      PERF_SCOPE(PERF_LV_TIMER);
+      wait_ms = lv_timer_handler();
     }
+    if (refr) {
+      if (parked && g_disp->inv_p) { lv_timer_resume(refr); wait_ms = 0; }   // a timer invalidated while parked
+      else if (g_disp->inv_p == 0 && lv_anim_count_running() == 0) lv_timer_pause(refr);
+    }
+    if (wait_ms > RENDER_IDLE_MAX_MS) wait_ms = RENDER_IDLE_MAX_MS;
   }
-  else if (pgn == 130306 && len >= 5) {            // Wind
-    uint16_t sp = (uint16_t)d[1] | ((uint16_t)d[2] << 8);
-    uint16_t ar = (uint16_t)d[3] | ((uint16_t)d[4] << 8);
-    float speed_ms = sp * 0.01f;
-    float angle_rad = ar * 0.0001f;
-    ui_update_wind(speed_ms, angle_rad);
+}
+
+// Pops CAN frames, decodes them into the signal store, feeds rollups and the
+// SD log. Woken by the ingest task whenever it queued frames.
+static void data_task(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(g_can_polled ? DATA_TASK_POLL_MS : DATA_TASK_IDLE_MS));
+    CanFrame f;
+    bool handled = false;
+    while (canbridge_read(f) && f.valid) { handle_frame(f); handled = true; }
+    if (handled && g_render_task) xTaskNotify(g_render_task, WAKE_DATA, eSetBits);
+    if (g_history_ready.load(std::memory_order_acquire)) {
+      uint32_t now = millis();
+      rollup_tick(g_batt_v, now);
+      rollup_tick(g_wind_speed, now);
+    }
   }
 }
 
-void loop() {
-  // LVGL v8 tick + handler
-  static uint32_t last = 0;
+static void start_tasks() {
+  if (xTaskCreatePinnedToCore(data_task, "data", DATA_TASK_STACK, nullptr,
+                              DATA_TASK_PRIO, &g_data_task, DATA_TASK_CORE) != pdPASS)
+    Serial.println("[task] data task failed");
+  if (xTaskCreatePinnedToCore(render_task, "render", RENDER_TASK_STACK, nullptr,
+                              RENDER_TASK_PRIO, &g_render_task, RENDER_TASK_CORE) != pdPASS)
+    Serial.println("[task] render task failed");
+}
+
+// ---------- Serial console ----------
+// Commands run in loop(), never in the render task. Anything that changes
+// LVGL state is posted in g_ui_req and applied on the render task's next pass.
+#if CONSOLE_ENABLE
+static void post_ui_request() {
+  if (g_render_task) xTaskNotify(g_render_task, WAKE_CONSOLE, eSetBits);
+}
+
+static void cmd_stats(Print& out, int, char**) {
+  display_render_stats_t r;
+  display_flush_stats_t fl;
+  display_get_render_stats(&r);
+  display_get_flush_stats(&fl);
+  out.printf("[stats] frames %lu  last %lu ms  avg %lu ms  max %lu ms\n", (unsigned long)r.frames,
+             (unsigned long)r.last_ms, (unsigned long)(r.frames ? r.total_ms / r.frames : 0), (unsigned long)r.max_ms);
+  out.printf("[stats] flushes %lu  in flush %lu us  dma %lu  busy %lu  bounce %lu  rot ppa/sw %lu/%lu\n",
+             (unsigned long)fl.flushes, (unsigned long)fl.flush_us, (unsigned long)fl.dma_done,
+             (unsigned long)fl.busy_retries, (unsigned long)fl.bounce_copies,
+             (unsigned long)fl.rotate_ppa, (unsigned long)fl.rotate_sw);
+  CanBridgeStats c = canbridge_get_stats();
+  out.printf("[stats] CAN frames %lu  queued %lu  high water %lu  overflows %lu  crc errors %lu\n",
+             (unsigned long)c.frames, (unsigned long)c.queued, (unsigned long)c.high_water,
+             (unsigned long)c.overflows, (unsigned long)c.crc_errors);
+  SdLogStats sd = sdlog_get_stats();
+  out.printf("[stats] SD flushes %lu  bytes %lu  last %lu us  max %lu us  backlog %lu  dropped %lu\n",
+             (unsigned long)sd.flushes, (unsigned long)sd.flushed_bytes, (unsigned long)sd.last_flush_us,
+             (unsigned long)sd.max_flush_us, (unsigned long)sd.backlog_bytes, (unsigned long)sd.dropped_bytes);
+  TouchStats t = touch_get_stats();
+  out.printf("[stats] touch irqs %lu  reads %lu  dropped %lu\n",
+             (unsigned long)t.irqs, (unsigned long)t.reads, (unsigned long)t.dropped);
+  GlyphCacheStats g = glyph_cache_get_stats();
+  out.printf("[stats] glyph cache %lu hits  %lu misses\n", (unsigned long)g.hits, (unsigned long)g.misses);
+}
+
+// Counts since boot and rates since the previous "pgn", fast-packet session
+// counters, the last GNSS fix and the devices seen.
+static void cmd_pgn(Print& out, int, char**) {
+  static uint32_t last_ms = 0;
+  static uint32_t last[g_pgn_table.size()];
   uint32_t now = millis();
-  uint32_t dt  = now - last;
-  if (dt >= 12) {
-    last = now;
-#if !defined(LV_TICK_CUSTOM) || (LV_TICK_CUSTOM == 0)
-    lv_tick_inc(dt);      // LVGL 8 API when using the built-in tick
+  float secs = (now - last_ms) / 1000.0f;
+  last_ms = now;
+  for (size_t i = 0; i < g_pgn_table.size(); i++) {
+    uint32_t n = g_pgn_count[i];
+    out.printf("[pgn] %6lu %10lu msgs %8.1f/s\n", (unsigned long)g_pgn_table.route(i).pgn,
+               (unsigned long)n, secs > 0 ? (n - last[i]) / secs : 0.0f);
+    last[i] = n;
+  }
+  out.printf("[pgn] unrouted frames %lu\n", (unsigned long)g_pgn_unrouted);
+  const N2kFastPacketStats& fp = g_fastpacket.stats;
+  out.printf("[pgn] fast-packet completed %lu  dropped frames %lu  incomplete %lu  evicted %lu\n",
+             (unsigned long)fp.completed, (unsigned long)fp.dropped, (unsigned long)fp.incomplete,
+             (unsigned long)fp.evicted);
+  SignalSample lat, lon, sats;
+  if (signal_get(SIG_GNSS_LAT, &lat) && signal_get(SIG_GNSS_LON, &lon))
+    out.printf("[pgn] gnss %.5f %.5f  fix %lu s ago\n", lat.value, lon.value, (unsigned long)((now - lat.ms) / 1000));
+  if (signal_get(SIG_GNSS_SATS, &sats)) out.printf("[pgn] gnss sats in view %u\n", (unsigned)sats.value);
+  for (const N2kDevice& e : g_devices)
+    if (e.used) out.printf("[pgn] device src %3u  product %5u  %s\n", e.src, e.product, e.model);
+}
+
+static void cmd_heap(Print& out, int, char**) {
+  static const struct { const char* name; uint32_t caps; } kHeaps[] = {
+    { "internal", MALLOC_CAP_INTERNAL }, { "dma", MALLOC_CAP_DMA }, { "psram", MALLOC_CAP_SPIRAM },
+  };
+  for (const auto& h : kHeaps)
+    out.printf("[heap] %-8s free %8u  min free %8u  largest %8u\n", h.name,
+               (unsigned)heap_caps_get_free_size(h.caps), (unsigned)heap_caps_get_minimum_free_size(h.caps),
+               (unsigned)heap_caps_get_largest_free_block(h.caps));
+}
+
+static void cmd_perf(Print& out, int argc, char** argv) {
+  if (argc > 1 && !strcmp(argv[1], "reset")) {
+    g_ui_req.perf_reset = true;   // the render task writes the histograms
+    post_ui_request();
+    out.println("[perf] reset requested");
+    return;
+  }
+  perf_trace_dump(out);
+}
+
+static void cmd_hud(Print& out, int argc, char** argv) {
+  int on = console_onoff(argc > 1 ? argv[1] : nullptr);
+  if (on < 0) { out.println("[con] usage: hud on|off"); return; }
+  g_ui_req.hud = on;
+  post_ui_request();
+}
+
+static void cmd_touchdot(Print& out, int argc, char** argv) {
+  int on = console_onoff(argc > 1 ? argv[1] : nullptr);
+  if (on < 0) { out.println("[con] usage: touchdot on|off"); return; }
+  g_ui_req.touch_dot = on;
+  post_ui_request();
+}
+
+static int parse_period(Print& out, int argc, char** argv) {
+  int ms = argc > 1 ? atoi(argv[1]) : 0;
+  if (ms < 1 || ms > 1000) { out.printf("[con] usage: %s <1..1000 ms>\n", argv[0]); return 0; }
+  return ms;
+}
+
+static void cmd_refr(Print& out, int argc, char** argv) {
+  if (int ms = parse_period(out, argc, argv)) { g_ui_req.refr_ms = ms; post_ui_request(); }
+}
+
+static void cmd_indev(Print& out, int argc, char** argv) {
+  if (int ms = parse_period(out, argc, argv)) { g_ui_req.indev_ms = ms; post_ui_request(); }
+}
+
+static void cmd_sdflush(Print& out, int, char**) {
+  sdlog_flush();
+  out.println("[SD] flush requested");
+}
+
+static const ConsoleCmd kConsoleCmds[] = {
+  { "stats",    "",            cmd_stats    },  // display, CAN, SD, touch, font counters
+  { "pgn",      "",            cmd_pgn      },  // per-PGN rates, fast-packet counters, GNSS, devices
+  { "heap",     "",            cmd_heap     },
+  { "perf",     "[reset]",     cmd_perf     },  // frame/flush histograms
+  { "hud",      "on|off",      cmd_hud      },
+  { "touchdot", "on|off",      cmd_touchdot },
+  { "refr",     "<ms>",        cmd_refr     },  // min spacing of data-driven UI passes
+  { "indev",    "<ms>",        cmd_indev    },  // touch read period
+  { "sdflush",  "",            cmd_sdflush  },
+};
 #endif
-    lv_timer_handler();   // LVGL 8 API
-  } else {
-    delay(1);
+
+static void console_start() {
+#if CONSOLE_ENABLE
+  console_begin(Serial, kConsoleCmds, sizeof(kConsoleCmds) / sizeof(kConsoleCmds[0]));
+  Serial.println("[con] ready, type help");
+#endif
+}
+
+// Housekeeping only; LVGL and the bus are handled by their own tasks.
+void loop() {
+  uint32_t now = millis();
+  static bool boot_reported = false;
+  if (!boot_reported && g_boot_touch.done && g_boot_storage.done) {
+    boot_reported = true;
+    boot_mark("all boot phases done");
   }
 
-  // CAN-bridge SLCAN read
-  CanFrame f;
-  if (canbridge_read(f) && f.valid) {
-    uint32_t pgn = n2k_pgn(f.id);
-    handle_pgn(pgn, f.data, f.len);
+  static uint32_t last_font_report = 0;
+  if (now - last_font_report >= 60000) {
+    last_font_report = now;
+    GlyphCacheStats g = glyph_cache_get_stats();
+    uint32_t total = g.hits + g.misses;
+    if (total) Serial.printf("[font] glyph cache %lu hits / %lu misses (%lu%%)\n",
+                             (unsigned long)g.hits, (unsigned long)g.misses, (unsigned long)(g.hits * 100ull / total));
   }
 
-  ui_tick();
+#if PERF_TRACE_ENABLE && PERF_TRACE_DUMP_MS
+  static uint32_t last_perf_dump = 0;
+  if (now - last_perf_dump >= PERF_TRACE_DUMP_MS) {
+    last_perf_dump = now;
+    perf_trace_dump(Serial);
+  }
+#endif
+
+#if CONSOLE_ENABLE
+  console_poll();
+  delay(CONSOLE_POLL_MS);
+#else
+  delay(100);
+#endif
 }
@@ -0,0 +1,29 @@
+#include "boot_sched.h"
+#include "config.h"
+
+void boot_mark(const char* what) {
+  Serial.printf("[boot] %5lu ms  %s\n", (unsigned long)millis(), what);
+}
+
+static void run_phase(BootPhase& p) {
+  p.start_ms = millis();
+  Serial.printf("[boot] %5lu ms  %s: start\n", (unsigned long)p.start_ms, p.name);
+  p.fn(p.arg);
+  p.end_ms = millis();
+  Serial.printf("[boot] %5lu ms  %s: done (%lu ms)\n", (unsigned long)p.end_ms, p.name,
+                (unsigned long)(p.end_ms - p.start_ms));
+  p.done = true;
+}
+
+static void phase_task(void* arg) {
+  run_phase(*(BootPhase*)arg);
+  vTaskDelete(nullptr);
+}
+
+void boot_start(BootPhase& p) {
+  p.done = false;
+  if (xTaskCreatePinnedToCore(phase_task, p.name, BOOT_TASK_STACK, &p, BOOT_TASK_PRIO,
+                              nullptr, BOOT_TASK_CORE) != pdPASS) {
+    run_phase(p);
+  }
+}
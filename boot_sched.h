@@ -0,0 +1,20 @@
+#pragma once
+#include <Arduino.h>
+
+// Boot phases that do not need LVGL (touch firmware, SD mount, history
+// restore) run as one-shot tasks on BOOT_TASK_CORE while setup() brings up
+// the panel and UI. Each phase logs start and end with ms-since-boot.
+typedef void (*BootFn)(void* arg);
+
+struct BootPhase {
+  const char*   name;
+  BootFn        fn;
+  void*         arg;
+  volatile bool done;
+  uint32_t      start_ms, end_ms;
+};
+
+// Prints "[boot]   123 ms  <what>".
+void boot_mark(const char* what);
+// Starts p in its own task; runs it inline if the task cannot be created.
+void boot_start(BootPhase& p);
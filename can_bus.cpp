@@ -1,9 +1,27 @@
 #include "can_bus.h"
+#include "config.h"
+#include "spsc_ring.h"
+
+struct SlcanParser { char line[64]; int pos; };
+// Binary frame: A5 | hdr (bit7 ext, bits0-3 len) | id u32 LE | data[len] | crc16 LE
+// CRC-16/CCITT-FALSE covers hdr..data. 16 bytes for an 8-byte frame vs 27 in SLCAN.
+static constexpr uint8_t CANBIN_SYNC = 0xA5;
+struct BinParser { uint8_t buf[1 + 1 + 4 + 8 + 2]; uint8_t pos; uint8_t need; };
+
 static Stream* g_ser = nullptr;
-static char g_line[64];
-static int g_pos = 0;
+static SlcanParser g_slcan = {};
+static BinParser g_bin = {};
+static uint8_t  g_mode = CANBRIDGE_PROTOCOL;
+static uint8_t  g_detect_kind = CANBRIDGE_PROTO_AUTO;
+static uint8_t  g_detect_streak = 0;
+static uint16_t g_rejects = 0;       // rejected lines/frames and discarded bytes since the last good frame
+static uint32_t g_crc_errors = 0;
+static SpscRing<CanFrame, CANBRIDGE_QUEUE_LEN> g_ring;
+static TaskHandle_t g_task = nullptr;
+static TaskHandle_t volatile g_consumer = nullptr;   // notified when frames are queued
+static uint32_t g_frames = 0;
 
-void canbridge_begin(Stream& serial){ g_ser=&serial; g_pos=0; }
+void canbridge_begin(Stream& serial){ g_ser=&serial; g_slcan.pos=0; g_bin.pos=0; }
 
 static int hexval(int c){
   if(c>='0'&&c<='9') return c-'0';
@@ -12,34 +30,144 @@ static int hexval(int c){
   return -1;
 }
 
+// Feeds one byte; returns true when it completed a valid "TiiiiiiiiLdd.." line.
+static bool slcan_feed(SlcanParser& p, int c, CanFrame& out){
+  if(c=='\r') return false;
+  if(c&0x80){ p.pos=0; g_rejects++; return false; }   // SLCAN is pure ASCII
+  if(c!='\n'){
+    if(p.pos < (int)sizeof(p.line)-1) p.line[p.pos++]=(char)c; else { p.pos=0; g_rejects++; }
+    return false;
+  }
+  int n=p.pos; p.pos=0;
+  p.line[n]=0; out.valid=false;
+  g_rejects++;
+  if(n<10 || p.line[0]!='T') return false;
+  uint32_t id=0;
+  for(int i=1;i<=8;i++){ int v=hexval(p.line[i]); if(v<0) return false; id=(id<<4)|v; }
+  int L=hexval(p.line[9]); if(L<0||L>8) return false;
+  if(n<10+L*2) return false;
+  for(int i=0;i<L;i++){
+    int hi=hexval(p.line[10+i*2]); int lo=hexval(p.line[11+i*2]);
+    if(hi<0||lo<0) return false;
+    out.data[i]=(uint8_t)((hi<<4)|lo);
+  }
+  out.id=id; out.len=(uint8_t)L; out.valid=true;
+  g_rejects=0;
+  return true;
+}
+
+// Nibble table: two lookups per byte instead of eight shift/xor steps.
+static const uint16_t kCrcNibble[16] = {
+  0x0000,0x1021,0x2042,0x3063,0x4084,0x50A5,0x60C6,0x70E7,
+  0x8108,0x9129,0xA14A,0xB16B,0xC18C,0xD1AD,0xE1CE,0xF1EF,
+};
+
+static uint16_t crc16_ccitt(const uint8_t* p, size_t n){
+  uint16_t crc=0xFFFF;
+  while(n--){
+    uint8_t b=*p++;
+    crc=(uint16_t)((crc<<4)^kCrcNibble[(crc>>12)^(b>>4)]);
+    crc=(uint16_t)((crc<<4)^kCrcNibble[(crc>>12)^(b&0x0F)]);
+  }
+  return crc;
+}
+
+static bool bin_feed(BinParser& p, uint8_t c, CanFrame& out);
+
+// After a bad frame, feeds its bytes after the sync back through the parser so
+// a real sync byte inside them is not lost. The tail is at most 15 bytes and a
+// frame is at least 8, so at most one frame can complete here.
+static bool bin_rescan(BinParser& p, uint8_t n, CanFrame& out){
+  uint8_t tail[sizeof(p.buf)];
+  memcpy(tail, p.buf+1, n-1);
+  p.pos=0;
+  bool got=false;
+  for(uint8_t i=0;i<n-1;i++) got|=bin_feed(p, tail[i], out);
+  return got;
+}
+
+static bool bin_feed(BinParser& p, uint8_t c, CanFrame& out){
+  if(p.pos==0){
+    if(c==CANBIN_SYNC) p.buf[p.pos++]=c;
+    else g_rejects++;   // hunting for sync: SLCAN text on a binary-locked link lands here
+    return false;
+  }
+  if(p.pos==1){
+    uint8_t L=c&0x0F;
+    if(L>8){ p.pos=0; g_rejects++; return false; }   // c is not a sync (0xA5 has L=5)
+    p.need=(uint8_t)(1+1+4+L+2);
+  }
+  p.buf[p.pos++]=c;
+  if(p.pos<p.need) return false;
+  uint8_t L=p.buf[1]&0x0F;
+  uint16_t crc=(uint16_t)p.buf[6+L] | ((uint16_t)p.buf[7+L]<<8);
+  if(crc16_ccitt(p.buf+1, 5+L)!=crc){ g_crc_errors++; g_rejects++; return bin_rescan(p, p.need, out); }
+  p.pos=0;
+  out.id=(uint32_t)p.buf[2] | ((uint32_t)p.buf[3]<<8) | ((uint32_t)p.buf[4]<<16) | ((uint32_t)p.buf[5]<<24);
+  out.len=L;
+  memcpy(out.data, p.buf+6, L);
+  out.valid=true;
+  g_rejects=0;
+  return true;
+}
+
+// Until the mode is known both decoders see every byte (SLCAN is pure ASCII,
+// the binary sync byte is not). A few consecutive frames of one kind lock the
+// mode; a long run of rejects while auto-locked starts detection again.
+static bool bridge_feed(int c, CanFrame& out){
+  uint8_t kind=CANBRIDGE_PROTO_AUTO;
+  if(g_mode!=CANBRIDGE_PROTO_BINARY && slcan_feed(g_slcan, c, out)) kind=CANBRIDGE_PROTO_SLCAN;
+  else if(g_mode!=CANBRIDGE_PROTO_SLCAN && bin_feed(g_bin, (uint8_t)c, out)) kind=CANBRIDGE_PROTO_BINARY;
+
+  if(g_mode==CANBRIDGE_PROTO_AUTO && kind!=CANBRIDGE_PROTO_AUTO){
+    if(kind==g_detect_kind) g_detect_streak++; else { g_detect_kind=kind; g_detect_streak=1; }
+    if(g_detect_streak>=CANBRIDGE_DETECT_FRAMES) g_mode=kind;
+  } else if(CANBRIDGE_PROTOCOL==CANBRIDGE_PROTO_AUTO && g_mode!=CANBRIDGE_PROTO_AUTO && g_rejects>=64){
+    g_mode=CANBRIDGE_PROTO_AUTO; g_detect_streak=0; g_rejects=0;
+  }
+  return kind!=CANBRIDGE_PROTO_AUTO;
+}
+
+static void ingest_task(void*){
+  CanFrame f;
+  for(;;){
+    // RX events notify us; the timeout only bounds latency if one is missed.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CANBRIDGE_INGEST_POLL_MS));
+    bool pushed=false;
+    while(g_ser->available()){
+      if(bridge_feed(g_ser->read(), f)){ g_frames++; pushed|=g_ring.push(f); }
+    }
+    TaskHandle_t c=g_consumer;
+    if(pushed && c) xTaskNotifyGive(c);
+  }
+}
+
+void canbridge_set_consumer(TaskHandle_t task){ g_consumer=task; }
+
+bool canbridge_start_task(HardwareSerial& uart){
+  if(g_task) return true;
+  canbridge_begin(uart);
+  uart.onReceive([](){ if(g_task) xTaskNotifyGive(g_task); });
+  return xTaskCreatePinnedToCore(ingest_task, "can_ingest", CANBRIDGE_TASK_STACK, nullptr,
+                                 CANBRIDGE_TASK_PRIO, &g_task, CANBRIDGE_TASK_CORE) == pdPASS;
+}
+
 bool canbridge_read(CanFrame& out){
+  if(g_task) return g_ring.pop(out);
   if(!g_ser) return false;
   while(g_ser->available()){
-    int c=g_ser->read();
-    if(c=='\r') continue;
-    if(c=='\n'){
-      g_line[g_pos]=0; out.valid=false;
-      if(g_pos>=11 && g_line[0]=='T'){
-        uint32_t id=0;
-        for(int i=1;i<=8;i++){ int v=hexval(g_line[i]); if(v<0){ g_pos=0; return false;} id=(id<<4)|v; }
-        int L=hexval(g_line[9]); if(L<0||L>8){ g_pos=0; return false; }
-        out.id=id; out.len=(uint8_t)L;
-        int expect=10+L*2;
-        if(g_pos>=expect){
-          for(int i=0;i<L;i++){
-            int hi=hexval(g_line[10+i*2]); int lo=hexval(g_line[11+i*2]);
-            if(hi<0||lo<0){ g_pos=0; return false; }
-            out.data[i]=(uint8_t)((hi<<4)|lo);
-          }
-          out.valid=true;
-        }
-      }
-      g_pos=0; if(out.valid) return true; return false;
-    }else{
-      if(g_pos < (int)sizeof(g_line)-1) g_line[g_pos++]=(char)c; else g_pos=0;
-    }
+    if(bridge_feed(g_ser->read(), out)){ g_frames++; return true; }
   }
   return false;
 }
 
+CanBridgeStats canbridge_get_stats(){
+  CanBridgeStats s;
+  s.frames=g_frames; s.queued=g_ring.size();
+  s.overflows=g_ring.overflows(); s.high_water=g_ring.high_water();
+  s.crc_errors=g_crc_errors; s.mode=g_mode;
+  return s;
+}
+
 uint32_t n2k_pgn(uint32_t id){ return (id>>8)&0x1FFFF; }
+uint8_t  n2k_src(uint32_t id){ return (uint8_t)(id&0xFF); }
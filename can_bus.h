@@ -1,6 +1,17 @@
 #pragma once
 #include <Arduino.h>
+#define CANBRIDGE_PROTO_AUTO   0
+#define CANBRIDGE_PROTO_SLCAN  1
+#define CANBRIDGE_PROTO_BINARY 2
 struct CanFrame { uint32_t id=0; uint8_t len=0; uint8_t data[8]={0}; bool valid=false; };
+struct CanBridgeStats { uint32_t frames; uint32_t queued; uint32_t overflows; uint32_t high_water; uint32_t crc_errors; uint8_t mode; };
 void canbridge_begin(Stream& serial);
+// Starts the ingest task: it wakes on UART RX events, runs the SLCAN parser and
+// queues frames; canbridge_read() then pops from that queue.
+bool canbridge_start_task(HardwareSerial& uart);
 bool canbridge_read(CanFrame& out);
+// Task to notify (xTaskNotifyGive) after the ingest task queued new frames.
+void canbridge_set_consumer(TaskHandle_t task);
+CanBridgeStats canbridge_get_stats();
 uint32_t n2k_pgn(uint32_t id);
+uint8_t  n2k_src(uint32_t id);
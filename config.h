@@ -6,7 +6,39 @@
 #define ORIENTATION_MODE 1
 #endif
 
-// ---------- CAN-bridge (SLCAN text "TxxxxxxxxLdd...") over UART ----------
+// ---------- Display flush path ----------
+// 1 = zero-copy present: LVGL draws in direct mode straight into two DPI
+//     framebuffers and the finished one is swapped in on vsync.
+// 0 = stripe rendering through the bounce buffer.
+// LVGL's sw_rotate cannot draw into a framebuffer, so direct mode is portrait only.
+#ifndef DISPLAY_DIRECT_MODE
+  #if ORIENTATION_MODE == 0
+    #define DISPLAY_DIRECT_MODE 1
+  #else
+    #define DISPLAY_DIRECT_MODE 0
+  #endif
+#endif
+#if DISPLAY_DIRECT_MODE && (ORIENTATION_MODE != 0)
+  #error "DISPLAY_DIRECT_MODE requires ORIENTATION_MODE 0"
+#endif
+// 1 = landscape without LVGL sw_rotate: stripes are rendered in landscape and
+//     rotated straight into the scan-out framebuffer by the PPA, with a tiled
+//     CPU kernel (rotate_rgb565.c) as fallback.
+#ifndef DISPLAY_HW_ROTATE
+  #define DISPLAY_HW_ROTATE (ORIENTATION_MODE == 1)
+#endif
+#ifndef DISPLAY_NUM_FBS
+  #define DISPLAY_NUM_FBS (DISPLAY_DIRECT_MODE ? 2 : 1)
+#endif
+
+// ---------- CAN-bridge over UART: SLCAN text "TxxxxxxxxLdd..." or binary frames ----------
+// 0=auto-detect, 1=SLCAN only, 2=binary only (A5 | hdr | id | data | crc16)
+#ifndef CANBRIDGE_PROTOCOL
+  #define CANBRIDGE_PROTOCOL 0
+#endif
+#ifndef CANBRIDGE_DETECT_FRAMES
+  #define CANBRIDGE_DETECT_FRAMES 3  // consecutive frames of one kind that lock auto-detect
+#endif
 #ifndef CANBRIDGE_UART
   #define CANBRIDGE_UART  Serial2
 #endif
@@ -19,9 +51,178 @@
 #ifndef CANBRIDGE_TX
   #define CANBRIDGE_TX    17
 #endif
+#ifndef CANBRIDGE_RX_BUF
+  #define CANBRIDGE_RX_BUF   4096  // UART driver RX buffer (bytes)
+#endif
+#ifndef CANBRIDGE_QUEUE_LEN
+  #define CANBRIDGE_QUEUE_LEN 256  // decoded frames between ingest task and loop(), power of two
+#endif
+#ifndef CANBRIDGE_TASK_CORE
+  #define CANBRIDGE_TASK_CORE 0
+#endif
+#ifndef CANBRIDGE_TASK_PRIO
+  #define CANBRIDGE_TASK_PRIO 5
+#endif
+#ifndef CANBRIDGE_TASK_STACK
+  #define CANBRIDGE_TASK_STACK 4096
+#endif
+#ifndef CANBRIDGE_INGEST_POLL_MS
+  #define CANBRIDGE_INGEST_POLL_MS 20
+#endif
+
+// ---------- Tasks ----------
+// The render task owns LVGL (tick, ui_tick, timers, flush); the data task pops
+// CAN frames, decodes them into the signal store and feeds rollups and the SD
+// log. Keep them on different cores so a busy bus cannot stall frames.
+#ifndef RENDER_TASK_CORE
+  #define RENDER_TASK_CORE   1
+#endif
+#ifndef RENDER_TASK_PRIO
+  #define RENDER_TASK_PRIO   4
+#endif
+#ifndef RENDER_TASK_STACK
+  #define RENDER_TASK_STACK  8192
+#endif
+#ifndef RENDER_PERIOD_MS
+  #define RENDER_PERIOD_MS   12     // min spacing of UI passes woken by new data (console: refr)
+#endif
+#ifndef RENDER_IDLE_MAX_MS
+  #define RENDER_IDLE_MAX_MS 1000   // longest sleep when LVGL has no timer due
+#endif
+#ifndef DATA_TASK_CORE
+  #define DATA_TASK_CORE     0
+#endif
+#ifndef DATA_TASK_PRIO
+  #define DATA_TASK_PRIO     3
+#endif
+#ifndef DATA_TASK_STACK
+  #define DATA_TASK_STACK    6144
+#endif
+#ifndef DATA_TASK_POLL_MS
+  #define DATA_TASK_POLL_MS  20     // UART poll period if the CAN ingest task is unavailable
+#endif
+#ifndef DATA_TASK_IDLE_MS
+  #define DATA_TASK_IDLE_MS  1000   // otherwise woken by frames; this only paces rollup snapshots
+#endif
+
+// ---------- Perf HUD ----------
+// Stats panel on lv_layer_top(): FPS, flush time, CPU, heap, CAN and SD.
+#ifndef PERF_HUD_AT_BOOT
+  #define PERF_HUD_AT_BOOT   0
+#endif
+#ifndef PERF_HUD_PERIOD_MS
+  #define PERF_HUD_PERIOD_MS 500
+#endif
+
+// ---------- Perf trace ----------
+// Cycle-count histograms around the LVGL timer handler, refresh and flush
+// paths (perf_trace.h). 0 compiles every probe out.
+#ifndef PERF_TRACE_ENABLE
+  #define PERF_TRACE_ENABLE  0
+#endif
+#ifndef PERF_TRACE_DUMP_MS
+  #define PERF_TRACE_DUMP_MS 60000   // periodic Serial dump; 0 = on request only
+#endif
+
+// ---------- Serial console ----------
+// Line commands on the USB serial port, parsed from loop() (type "help").
+#ifndef CONSOLE_ENABLE
+  #define CONSOLE_ENABLE     1
+#endif
+#ifndef CONSOLE_LINE_MAX
+  #define CONSOLE_LINE_MAX   96
+#endif
+#ifndef CONSOLE_POLL_MS
+  #define CONSOLE_POLL_MS    20
+#endif
+
+// ---------- Boot ----------
+// Touch firmware load and SD mount/restore run as tasks on this core while
+// setup() brings up the panel and UI.
+#ifndef BOOT_TASK_CORE
+  #define BOOT_TASK_CORE  0
+#endif
+#ifndef BOOT_TASK_PRIO
+  #define BOOT_TASK_PRIO  3
+#endif
+#ifndef BOOT_TASK_STACK
+  #define BOOT_TASK_STACK 6144
+#endif
 
 // ---------- SD card ----------
 #define USE_SD_MMC 1   // 1=on-board TF slot with SD_MMC, 0=classic SD+SPI
+// Log lines are buffered in RAM and written by a background task once a series
+// holds SDLOG_FLUSH_BYTES or its oldest line is SDLOG_FLUSH_AGE_MS old.
+// 0 = CSV text (ms,value), 1 = binary .tsl blocks (tslog_codec.h; convert
+// with tools/tsl2csv). Values are rounded to SDLOG_TSL_MANTISSA_BITS (23 =
+// lossless; 15 is at least as precise as the CSV's 3 decimals for |v| < 64)
+// and a block is sealed after SDLOG_TSL_BLOCK_SAMPLES samples, so at most that
+// many samples per series are only in RAM (sdlog_flush() seals early).
+// On rollup means 15-bit blocks come out ~5.2x smaller than CSV, lossless
+// ~4x (tests/test_tslog).
+#ifndef SDLOG_FORMAT
+  #define SDLOG_FORMAT       1
+#endif
+#ifndef SDLOG_TSL_MANTISSA_BITS
+  #define SDLOG_TSL_MANTISSA_BITS 15
+#endif
+#ifndef SDLOG_TSL_BLOCK_SAMPLES
+  #define SDLOG_TSL_BLOCK_SAMPLES 32
+#endif
+// Rollup rings are snapshotted to SD this often and restored at boot.
+#ifndef ROLLUP_SNAPSHOT_MS
+  #define ROLLUP_SNAPSHOT_MS 600000
+#endif
+#ifndef SDLOG_MAX_SERIES
+  #define SDLOG_MAX_SERIES   8
+#endif
+#ifndef SDLOG_BUF_BYTES
+  #define SDLOG_BUF_BYTES    4096   // per series, x2 (double buffered)
+#endif
+#ifndef SDLOG_FLUSH_BYTES
+  #define SDLOG_FLUSH_BYTES  2048
+#endif
+#ifndef SDLOG_FLUSH_AGE_MS
+  #define SDLOG_FLUSH_AGE_MS 30000
+#endif
+#ifndef SDLOG_CHECK_MS
+  #define SDLOG_CHECK_MS     1000
+#endif
+#ifndef SDLOG_TASK_CORE
+  #define SDLOG_TASK_CORE    0
+#endif
+#ifndef SDLOG_TASK_PRIO
+  #define SDLOG_TASK_PRIO    1
+#endif
+#ifndef SDLOG_TASK_STACK
+  #define SDLOG_TASK_STACK   4096
+#endif
+
+// ---------- Touch input ----------
+// TOUCH_USE_INT=1: the controller is read by a task woken from the TP_INT edge
+// (and polled every TOUCH_RELEASE_POLL_MS while a finger is down, to catch the
+// release); LVGL pops the samples from a queue. 0 = poll from indev_read_cb.
+#ifndef TOUCH_USE_INT
+  #define TOUCH_USE_INT         1
+#endif
+#ifndef TOUCH_INT_ACTIVE_HIGH
+  #define TOUCH_INT_ACTIVE_HIGH 1   // GSL3680 raises INT when a report is ready
+#endif
+#ifndef TOUCH_RELEASE_POLL_MS
+  #define TOUCH_RELEASE_POLL_MS 20
+#endif
+#ifndef TOUCH_QUEUE_LEN
+  #define TOUCH_QUEUE_LEN       8
+#endif
+#ifndef TOUCH_TASK_CORE
+  #define TOUCH_TASK_CORE       0
+#endif
+#ifndef TOUCH_TASK_PRIO
+  #define TOUCH_TASK_PRIO       4
+#endif
+#ifndef TOUCH_TASK_STACK
+  #define TOUCH_TASK_STACK      4096
+#endif
 
 // ---------- Touch orientation compensation (after vendor driver's rotation) ----------
 #ifndef TOUCH_SWAP_XY
@@ -0,0 +1,63 @@
+#include "console.h"
+#include "config.h"
+#include <string.h>
+
+#define CONSOLE_MAX_ARGS 6
+
+static Stream*           g_io = nullptr;
+static const ConsoleCmd* g_cmds = nullptr;
+static size_t            g_count = 0;
+static char              g_line[CONSOLE_LINE_MAX];
+static size_t            g_len = 0;
+static bool              g_overflow = false;
+
+void console_begin(Stream& io, const ConsoleCmd* cmds, size_t count) {
+  g_io = &io; g_cmds = cmds; g_count = count;
+  g_len = 0; g_overflow = false;
+}
+
+int console_onoff(const char* s) {
+  if (!s) return -1;
+  if (!strcmp(s, "on") || !strcmp(s, "1")) return 1;
+  if (!strcmp(s, "off") || !strcmp(s, "0")) return 0;
+  return -1;
+}
+
+static void print_help(Print& out) {
+  out.println("[con] commands:");
+  for (size_t i = 0; i < g_count; i++)
+    out.printf("[con]   %s %s\n", g_cmds[i].name, g_cmds[i].usage ? g_cmds[i].usage : "");
+}
+
+static void run_line(char* line) {
+  char* argv[CONSOLE_MAX_ARGS];
+  int argc = 0;
+  for (char* tok = strtok(line, " \t"); tok && argc < CONSOLE_MAX_ARGS; tok = strtok(nullptr, " \t"))
+    argv[argc++] = tok;
+  if (argc == 0) return;
+  if (!strcmp(argv[0], "help") || !strcmp(argv[0], "?")) { print_help(*g_io); return; }
+  for (size_t i = 0; i < g_count; i++) {
+    if (!strcmp(argv[0], g_cmds[i].name)) { g_cmds[i].run(*g_io, argc, argv); return; }
+  }
+  g_io->printf("[con] unknown command '%s' (try help)\n", argv[0]);
+}
+
+void console_poll() {
+  if (!g_io) return;
+  int avail = g_io->available();
+  while (avail-- > 0) {
+    int c = g_io->read();
+    if (c < 0) break;
+    if (c == '\r' || c == '\n') {
+      if (g_overflow) g_io->println("[con] line too long, ignored");
+      else if (g_len) { g_line[g_len] = '\0'; run_line(g_line); }
+      g_len = 0; g_overflow = false;
+    } else if (c == 0x08 || c == 0x7F) {
+      if (g_len) g_len--;
+    } else if (g_len < sizeof(g_line) - 1) {
+      g_line[g_len++] = (char)c;
+    } else {
+      g_overflow = true;
+    }
+  }
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <Arduino.h>
+
+// Line-based command console on a Stream. console_poll() never blocks: it
+// takes whatever bytes have arrived and runs one command per complete line
+// ("name arg arg ..."). Handlers run in the polling task, so anything that
+// touches LVGL must be handed to the render task instead of done inline.
+struct ConsoleCmd {
+  const char* name;
+  const char* usage;   // argument summary for "help"
+  void (*run)(Print& out, int argc, char** argv);   // argv[0] is the name
+};
+
+void console_begin(Stream& io, const ConsoleCmd* cmds, size_t count);
+void console_poll();
+// "on"/"1" -> 1, "off"/"0" -> 0, anything else -> -1.
+int console_onoff(const char* s);
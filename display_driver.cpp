@@ -8,9 +8,20 @@
 #include "esp_lcd_panel_ops.h"
 #include "esp_heap_caps.h"
 #include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_lcd_mipi_dsi.h"
+#include "freertos/semphr.h"
+#include "esp_cache.h"
+#include "esp_timer.h"
+#if __has_include("driver/ppa.h")
+  #include "driver/ppa.h"
+  #define HAVE_PPA 1
+#endif
 
 #include "esp_lcd_jd9365.h"
 #include "jd9365_lcd.h"
+#include "rotate_rgb565.h"
+#include "perf_trace.h"
 
 extern esp_lcd_panel_handle_t panel_handle;
 
@@ -27,11 +38,55 @@ static lv_color_t* lv_buf2 = nullptr;
 static lv_color_t* bounce  = nullptr;
 static size_t      bounce_bytes = 0;
 
+static display_flush_stats_t  s_stats = {};
+static display_render_stats_t s_render = {};
+
+// Adds the time spent in a flush callback to s_stats.flush_us.
+struct FlushTimer {
+  int64_t t0 = esp_timer_get_time();
+  ~FlushTimer() { s_stats.flush_us += (uint32_t)(esp_timer_get_time() - t0); }
+};
+
+// LVGL reports every finished refresh here: time spent and pixels redrawn.
+static void render_monitor_cb(lv_disp_drv_t* disp, uint32_t time_ms, uint32_t px) {
+  (void)disp;
+  s_render.frames++;
+  s_render.last_ms = time_ms;
+  s_render.total_ms += time_ms;
+  if (time_ms > s_render.max_ms) s_render.max_ms = time_ms;
+  s_render.last_px = px;
+  s_render.total_px += px;
+}
+
+// Set while a DMA transfer owns the flush; the color-transfer-done callback
+// releases LVGL from there so it can render the next stripe meanwhile.
+static lv_disp_drv_t* volatile s_flush_drv = nullptr;
+static SemaphoreHandle_t       s_dma_done_sem = nullptr;
+
+static bool IRAM_ATTR on_dpi_color_trans_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata, void* user_ctx) {
+  (void)panel; (void)edata; (void)user_ctx;
+  s_stats.dma_done++;
+  lv_disp_drv_t* drv = s_flush_drv;
+  if (drv) { s_flush_drv = nullptr; lv_disp_flush_ready(drv); }
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(s_dma_done_sem, &woken);
+  return woken == pdTRUE;
+}
+
+// LVGL spins here while the previous stripe is still in flight.
+static void stripe_wait_cb(lv_disp_drv_t* disp) {
+  (void)disp;
+  xSemaphoreTake(s_dma_done_sem, 1);
+}
+
+// With async completion LVGL never flushes twice without flush_ready, so the
+// busy path should stay at zero; it is kept (and counted) as a safety net.
 static esp_err_t draw_bitmap_retry(int x1, int y1, int x2, int y2, const void* data) {
+  PERF_SCOPE(PERF_DRAW_BITMAP);
   esp_err_t err;
   do {
     err = esp_lcd_panel_draw_bitmap(panel_handle, x1, y1, x2, y2, data);
-    if (err == ESP_ERR_INVALID_STATE) vTaskDelay(pdMS_TO_TICKS(1));
+    if (err == ESP_ERR_INVALID_STATE) { s_stats.busy_retries++; vTaskDelay(pdMS_TO_TICKS(1)); }
   } while (err == ESP_ERR_INVALID_STATE);
   return err;
 }
@@ -40,33 +95,187 @@ static void my_disp_flush(lv_disp_drv_t* disp, const lv_area_t* a, lv_color_t* p
   int32_t w = a->x2 - a->x1 + 1;  if (w > NATIVE_W) w = NATIVE_W;
   int32_t h = a->y2 - a->y1 + 1;
   size_t need = (size_t)w * h * sizeof(lv_color_t);
+  s_stats.flushes++;
+  FlushTimer timer;
+  PERF_SCOPE(PERF_FLUSH);
 
-  if (need > bounce_bytes) {
-    int rows_fit = (int)(bounce_bytes / (w * sizeof(lv_color_t)));
-    if (rows_fit < 1) rows_fit = 1;
-    int y = a->y1;
-    const lv_color_t* src = px;
-    int remain = h;
-    while (remain > 0) {
-      int rows = (remain < rows_fit) ? remain : rows_fit;
-      size_t chunk = (size_t)w * rows * sizeof(lv_color_t);
-      memcpy(bounce, src, chunk);
-      draw_bitmap_retry(a->x1, y, a->x1 + w, y + rows, (const void*)bounce);
-      src += w * rows; y += rows; remain -= rows;
+  // Our own stripe buffers are DMA-capable: hand them to the DMA as-is.
+  // Anything else (e.g. LVGL's sw_rotate scratch buffer) goes through bounce.
+  const void* src = px;
+  if (px != lv_buf1 && px != lv_buf2) {
+    if (need > bounce_bytes) {
+      // Oversized foreign buffer: push it through the bounce buffer in chunks,
+      // waiting for each transfer before the bounce buffer is reused.
+      int rows_fit = (int)(bounce_bytes / (w * sizeof(lv_color_t)));
+      if (rows_fit < 1) rows_fit = 1;
+      int y = a->y1;
+      const lv_color_t* p = px;
+      int remain = h;
+      while (remain > 0) {
+        int rows = (remain < rows_fit) ? remain : rows_fit;
+        size_t chunk = (size_t)w * rows * sizeof(lv_color_t);
+        {
+          PERF_SCOPE(PERF_BOUNCE_COPY);
+          memcpy(bounce, p, chunk);
+        }
+        s_stats.bounce_copies++;
+        xSemaphoreTake(s_dma_done_sem, 0);
+        if (draw_bitmap_retry(a->x1, y, a->x1 + w, y + rows, (const void*)bounce) == ESP_OK) {
+          xSemaphoreTake(s_dma_done_sem, portMAX_DELAY);
+        }
+        p += w * rows; y += rows; remain -= rows;
+      }
+      lv_disp_flush_ready(disp);
+      return;
     }
+    {
+      PERF_SCOPE(PERF_BOUNCE_COPY);
+      memcpy(bounce, px, need);
+    }
+    s_stats.bounce_copies++;
+    src = bounce;
+  }
+
+  s_flush_drv = disp;
+  if (draw_bitmap_retry(a->x1, a->y1, a->x1 + w, a->y1 + h, src) != ESP_OK) {
+    s_flush_drv = nullptr;
     lv_disp_flush_ready(disp);
-    return;
   }
+}
 
-  memcpy(bounce, px, need);
-  draw_bitmap_retry(a->x1, a->y1, a->x1 + w, a->y1 + h, (const void*)bounce);
+#if DISPLAY_HW_ROTATE
+// Landscape: LVGL renders 1280-wide stripes and each one is rotated while it
+// is copied into the scan-out framebuffer, which replaces sw_rotate, the
+// bounce memcpy and the DPI copy with a single pass.
+static uint16_t* s_scanout = nullptr;
+static size_t    s_scanout_bytes = 0;
+#if HAVE_PPA
+static ppa_client_handle_t s_ppa = nullptr;
+
+static bool IRAM_ATTR on_ppa_trans_done(ppa_client_handle_t client, ppa_event_data_t* edata, void* user_data) {
+  (void)client; (void)edata;
+  lv_disp_flush_ready((lv_disp_drv_t*)user_data);
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(s_dma_done_sem, &woken);
+  return woken == pdTRUE;
+}
+#endif
+
+static void rotate_flush(lv_disp_drv_t* disp, const lv_area_t* a, lv_color_t* px) {
+  int32_t w = a->x2 - a->x1 + 1;
+  int32_t h = a->y2 - a->y1 + 1;
+  // Same mapping as LVGL's LV_DISP_ROT_90: logical (x, y) -> native (y, NATIVE_H-1-x)
+  int32_t nx = a->y1;
+  int32_t ny = NATIVE_H - 1 - a->x2;
+  s_stats.flushes++;
+  FlushTimer timer;
+  PERF_SCOPE(PERF_FLUSH);
+
+#if HAVE_PPA
+  if (s_ppa) {
+    ppa_srm_oper_config_t op = {};
+    op.in.buffer         = px;
+    op.in.pic_w          = w;
+    op.in.pic_h          = h;
+    op.in.block_w        = w;
+    op.in.block_h        = h;
+    op.in.srm_cm         = PPA_SRM_COLOR_MODE_RGB565;
+    op.out.buffer        = s_scanout;
+    op.out.buffer_size   = s_scanout_bytes;
+    op.out.pic_w         = NATIVE_W;
+    op.out.pic_h         = NATIVE_H;
+    op.out.block_offset_x = nx;
+    op.out.block_offset_y = ny;
+    op.out.srm_cm        = PPA_SRM_COLOR_MODE_RGB565;
+    op.rotation_angle    = PPA_SRM_ROTATION_ANGLE_90;  // counter-clockwise, matches the mapping above
+    op.scale_x           = 1.0f;
+    op.scale_y           = 1.0f;
+    op.mode              = PPA_TRANS_MODE_NON_BLOCKING;
+    op.user_data         = disp;
+    if (ppa_do_scale_rotate_mirror(s_ppa, &op) == ESP_OK) { s_stats.rotate_ppa++; return; }
+  }
+#endif
+
+  uint16_t* dst = s_scanout + (size_t)ny * NATIVE_W + nx;
+  rotate90_rgb565((const uint16_t*)px, w, h, w, dst, NATIVE_W);
+  esp_cache_msync(dst, ((size_t)(w - 1) * NATIVE_W + h) * sizeof(uint16_t),
+                  ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+  s_stats.rotate_sw++;
   lv_disp_flush_ready(disp);
 }
 
-lv_disp_t* display_port_init(void) {
-  lcd.begin();
-  lv_init();
+static void rotate_mode_init(void) {
+  void* fb = nullptr;
+  ESP_ERROR_CHECK(esp_lcd_dpi_panel_get_frame_buffer(panel_handle, 1, &fb));
+  s_scanout = (uint16_t*)fb;
+  s_scanout_bytes = (size_t)NATIVE_W * NATIVE_H * sizeof(uint16_t);
+#if HAVE_PPA
+  ppa_client_config_t pc = {};
+  pc.oper_type = PPA_OPERATION_SRM;
+  pc.max_pending_trans_num = 1;
+  if (ppa_register_client(&pc, &s_ppa) == ESP_OK) {
+    ppa_event_callbacks_t pcb = {};
+    pcb.on_trans_done = on_ppa_trans_done;
+    ppa_client_register_event_callbacks(s_ppa, &pcb);
+  } else {
+    s_ppa = nullptr;
+    Serial.println("PPA client unavailable; rotating on the CPU.");
+  }
+#endif
+}
+#endif
+
+#if DISPLAY_DIRECT_MODE
+// Zero-copy present: LVGL renders in direct mode into the DPI framebuffers.
+// On the last area of a frame the finished buffer becomes the front buffer
+// (draw_bitmap only switches the scan-out index when handed a framebuffer),
+// and we wait for vsync before LVGL may touch the other one. LVGL itself
+// copies the dirty areas over to the new back buffer after flush_ready.
+static void*             s_fb[2] = { nullptr, nullptr };
+static SemaphoreHandle_t s_vsync_sem = nullptr;
 
+static bool IRAM_ATTR on_dpi_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata, void* user_ctx) {
+  (void)panel; (void)edata; (void)user_ctx;
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(s_vsync_sem, &woken);
+  return woken == pdTRUE;
+}
+
+static void direct_flush(lv_disp_drv_t* disp, const lv_area_t* a, lv_color_t* px) {
+  (void)a;
+  FlushTimer timer;
+  PERF_SCOPE(PERF_FLUSH);
+  if (lv_disp_flush_is_last(disp)) {
+    xSemaphoreTake(s_vsync_sem, 0);  // drop a stale vsync from the previous frame
+    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, NATIVE_W, NATIVE_H, (const void*)px);
+    xSemaphoreTake(s_vsync_sem, portMAX_DELAY);
+  }
+  lv_disp_flush_ready(disp);
+}
+
+static lv_disp_t* direct_mode_init(void) {
+  ESP_ERROR_CHECK(esp_lcd_dpi_panel_get_frame_buffer(panel_handle, 2, &s_fb[0], &s_fb[1]));
+  s_vsync_sem = xSemaphoreCreateBinary();
+  esp_lcd_dpi_panel_event_callbacks_t cbs = {};
+  cbs.on_refresh_done = on_dpi_refresh_done;
+  ESP_ERROR_CHECK(esp_lcd_dpi_panel_register_event_callbacks(panel_handle, &cbs, nullptr));
+
+  lv_disp_draw_buf_init(&draw_buf, s_fb[0], s_fb[1], (size_t)NATIVE_W * NATIVE_H);
+
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res     = NATIVE_W;
+  disp_drv.ver_res     = NATIVE_H;
+  disp_drv.draw_buf    = &draw_buf;
+  disp_drv.flush_cb    = direct_flush;
+  disp_drv.direct_mode = 1;
+  disp_drv.monitor_cb  = render_monitor_cb;
+  STRIPE_LINES = NATIVE_H;
+  return lv_disp_drv_register(&disp_drv);
+}
+#endif
+
+static lv_disp_t* stripe_mode_init(void) {
   auto allocDMA = [&](size_t sz)->lv_color_t* {
     return (lv_color_t*)heap_caps_aligned_alloc(64, sz, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
   };
@@ -90,20 +299,39 @@ lv_disp_t* display_port_init(void) {
     }
   }
 
+#if !DISPLAY_HW_ROTATE
   bounce_bytes = (size_t)NATIVE_W * STRIPE_LINES * sizeof(lv_color_t);
   bounce = allocDMA(bounce_bytes);
   if (!bounce) {
     Serial.println("Bounce buffer alloc failed; reduce STRIPE_LINES.");
     while (1) vTaskDelay(pdMS_TO_TICKS(1000));
   }
+#endif
+
+  s_dma_done_sem = xSemaphoreCreateBinary();
+#if DISPLAY_HW_ROTATE
+  rotate_mode_init();
+#else
+  esp_lcd_dpi_panel_event_callbacks_t cbs = {};
+  cbs.on_color_trans_done = on_dpi_color_trans_done;
+  ESP_ERROR_CHECK(esp_lcd_dpi_panel_register_event_callbacks(panel_handle, &cbs, nullptr));
+#endif
 
   lv_disp_draw_buf_init(&draw_buf, lv_buf1, lv_buf2, (size_t)NATIVE_W * STRIPE_LINES);
 
   static lv_disp_drv_t disp_drv;
   lv_disp_drv_init(&disp_drv);
+  disp_drv.draw_buf = &draw_buf;
+  disp_drv.wait_cb  = stripe_wait_cb;
+  disp_drv.monitor_cb = render_monitor_cb;
+#if DISPLAY_HW_ROTATE
+  disp_drv.hor_res  = NATIVE_H;
+  disp_drv.ver_res  = NATIVE_W;
+  disp_drv.flush_cb = rotate_flush;
+  lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
+#else
   disp_drv.hor_res  = NATIVE_W;
   disp_drv.ver_res  = NATIVE_H;
-  disp_drv.draw_buf = &draw_buf;
   disp_drv.flush_cb = my_disp_flush;
 #if ORIENTATION_MODE == 1
   disp_drv.sw_rotate = 1;
@@ -111,6 +339,30 @@ lv_disp_t* display_port_init(void) {
   lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
 #if ORIENTATION_MODE == 1
   lv_disp_set_rotation(disp, LV_DISP_ROT_90);
+#endif
+#endif
+  return disp;
+}
+
+#if PERF_TRACE_ENABLE
+// Stands in for LVGL's refresh timer callback to time whole frames.
+static void traced_refr_timer(lv_timer_t* t) {
+  PERF_SCOPE(PERF_REFR);
+  _lv_disp_refr_timer(t);
+}
+#endif
+
+lv_disp_t* display_port_init(void) {
+  lcd.begin();
+  lv_init();
+#if DISPLAY_DIRECT_MODE
+  lv_disp_t* disp = direct_mode_init();
+#else
+  lv_disp_t* disp = stripe_mode_init();
+#endif
+#if PERF_TRACE_ENABLE
+  lv_timer_t* refr = _lv_disp_get_refr_timer(disp);
+  if (refr) refr->timer_cb = traced_refr_timer;
 #endif
   return disp;
 }
@@ -118,3 +370,6 @@ lv_disp_t* display_port_init(void) {
 int display_get_stripe_lines(void) { return STRIPE_LINES; }
 int display_get_native_w(void){ return NATIVE_W; }
 int display_get_native_h(void){ return NATIVE_H; }
+void display_get_flush_stats(display_flush_stats_t* out) { if (out) *out = s_stats; }
+void display_get_render_stats(display_render_stats_t* out) { if (out) *out = s_render; }
+void display_reset_render_stats(void) { s_render = {}; }
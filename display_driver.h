@@ -3,10 +3,32 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+typedef struct {
+  uint32_t flushes;        // flush_cb calls
+  uint32_t dma_done;       // color-transfer-done callbacks
+  uint32_t busy_retries;   // draw_bitmap returned ESP_ERR_INVALID_STATE
+  uint32_t bounce_copies;  // areas copied through the bounce buffer
+  uint32_t rotate_ppa;     // areas rotated into the framebuffer by the PPA
+  uint32_t rotate_sw;      // areas rotated by the CPU fallback kernel
+  uint32_t flush_us;       // total time spent inside flush_cb
+} display_flush_stats_t;
+
+typedef struct {
+  uint32_t frames;         // completed refresh cycles
+  uint32_t last_ms;        // render + flush time of the last frame
+  uint32_t max_ms;         // worst frame since the last reset
+  uint32_t total_ms;
+  uint32_t last_px;        // pixels redrawn by the last frame
+  uint64_t total_px;
+} display_render_stats_t;
+
 lv_disp_t* display_port_init(void);
 int display_get_stripe_lines(void);
 int display_get_native_w(void);
 int display_get_native_h(void);
+void display_get_flush_stats(display_flush_stats_t* out);
+void display_get_render_stats(display_render_stats_t* out);
+void display_reset_render_stats(void);
 #ifdef __cplusplus
 }
 #endif
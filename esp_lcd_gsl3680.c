@@ -6,6 +6,7 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "driver/i2c_master.h"
 #include "esp_lcd_panel_io.h"
@@ -635,29 +636,58 @@ static esp_err_t touch_gsl3680_i2c_write(esp_lcd_touch_handle_t tp, uint16_t reg
     // // *INDENT-ON*
 }
 
+/* Consecutive registers (offset +4) after a page select are sent as one
+ * auto-incrementing burst of up to GSL3680_FW_BURST words instead of one I2C
+ * transaction per word: the table's 4356 writes go out in 264 transfers at
+ * the default of 32. GSL3680_FW_BURST 1 gives the original word-by-word load. */
+#ifndef GSL3680_FW_BURST
+#define GSL3680_FW_BURST 32
+#endif
+/* The burst length goes through touch_gsl3680_i2c_write's uint8_t len */
+_Static_assert(GSL3680_FW_BURST >= 1 && GSL3680_FW_BURST * 4 <= 255, "GSL3680_FW_BURST must be 1..63");
+
 static esp_err_t esp_lcd_touch_gsl3680_load_fw(esp_lcd_touch_handle_t tp)
 {
     ESP_LOGI(TAG,"start load fw");
-    uint16_t addr;
-    unsigned char wrbuf[4];
-    uint16_t source_line = 0;
+    static uint8_t burst[GSL3680_FW_BURST * 4];
     uint16_t source_len = sizeof(GSLX680_FW) / sizeof(struct fw_data);
+    uint16_t burst_reg = 0, burst_words = 0;
+    uint32_t transfers = 0;
+    esp_err_t ret = ESP_OK;
+    int64_t t0 = esp_timer_get_time();
 
-    for(source_line=0;source_line<source_len;source_line++)
+    for (uint16_t line = 0; line < source_len && ret == ESP_OK; line++)
     {
-        addr = GSLX680_FW[source_line].offset;
-        wrbuf[0] = (uint8_t)(GSLX680_FW[source_line].val & 0x000000ff);
-        wrbuf[1] = (uint8_t)((GSLX680_FW[source_line].val & 0x0000ff00) >> 8);
-        wrbuf[2] = (uint8_t)((GSLX680_FW[source_line].val & 0x00ff0000) >> 16);
-        wrbuf[3] = (uint8_t)((GSLX680_FW[source_line].val & 0xff000000) >> 24);
-        if(addr == 0xf0)
-            touch_gsl3680_i2c_write(tp,addr,wrbuf,1);
-        else
-            touch_gsl3680_i2c_write(tp,addr,wrbuf,4);
-        
+        uint8_t addr = (uint8_t)GSLX680_FW[line].offset;
+        uint32_t val = GSLX680_FW[line].val;
+        bool contiguous = burst_words && addr != 0xf0 && addr == burst_reg + burst_words * 4 &&
+                          burst_words < GSL3680_FW_BURST;
+        if (burst_words && !contiguous) {
+            ret = touch_gsl3680_i2c_write(tp, burst_reg, burst, burst_words * 4);
+            transfers++;
+            burst_words = 0;
+        }
+        if (addr == 0xf0) {
+            uint8_t page = (uint8_t)val;
+            if (ret == ESP_OK) ret = touch_gsl3680_i2c_write(tp, addr, &page, 1);
+            transfers++;
+            continue;
+        }
+        if (!burst_words) burst_reg = addr;
+        uint8_t *p = &burst[burst_words * 4];
+        p[0] = (uint8_t)(val & 0x000000ff);
+        p[1] = (uint8_t)((val & 0x0000ff00) >> 8);
+        p[2] = (uint8_t)((val & 0x00ff0000) >> 16);
+        p[3] = (uint8_t)((val & 0xff000000) >> 24);
+        burst_words++;
     }
-    ESP_LOGI(TAG,"load fw success");
-    return ESP_OK;
+    if (burst_words && ret == ESP_OK) {
+        ret = touch_gsl3680_i2c_write(tp, burst_reg, burst, burst_words * 4);
+        transfers++;
+    }
+    ESP_LOGI(TAG, "load fw %s: %u entries in %lu transfers, %lld ms", ret == ESP_OK ? "ok" : "failed",
+             source_len, (unsigned long)transfers, (long long)((esp_timer_get_time() - t0) / 1000));
+    return ret;
 }
 
 static esp_err_t esp_lcd_touch_gsl3680_clear_reg(esp_lcd_touch_handle_t tp)
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// Float-to-text for value labels without newlib's float printf: scale, round
+// half away from zero, print the integer. decimals is 0..2. Writes at most 15
+// chars plus NUL. NaN and values with |v| * 10^decimals >= 4e9 (+-4e9, 4e8,
+// 4e7 for 0, 1, 2 decimals) print as "--". Returns length.
+static inline int fmt_fixed(char* out, float v, uint8_t decimals) {
+  static const float kScale[3] = { 1.0f, 10.0f, 100.0f };
+  if (decimals > 2) decimals = 2;
+  bool neg = v < 0;
+  float a = (neg ? -v : v) * kScale[decimals] + 0.5f;
+  if (!(a < 4e9f)) { out[0] = '-'; out[1] = '-'; out[2] = 0; return 2; }   // also NaN
+  uint32_t n = (uint32_t)a;
+
+  char tmp[16]; int i = 0;
+  for (uint8_t d = 0; d < decimals; d++) { tmp[i++] = '0' + n % 10; n /= 10; }
+  if (decimals) tmp[i++] = '.';
+  do { tmp[i++] = '0' + n % 10; n /= 10; } while (n);
+  bool zero = true;
+  for (int k = 0; k < i; k++) if (tmp[k] > '0') { zero = false; break; }
+  if (neg && !zero) tmp[i++] = '-';   // no "-0.0"
+
+  int len = 0;
+  while (i) out[len++] = tmp[--i];
+  out[len] = 0;
+  return len;
+}
+
+static inline int fmt_uint(char* out, uint32_t n) {
+  char tmp[11]; int i = 0, len = 0;
+  do { tmp[i++] = '0' + n % 10; n /= 10; } while (n);
+  while (i) out[len++] = tmp[--i];
+  out[len] = 0;
+  return len;
+}
@@ -0,0 +1,94 @@
+#include "glyph_cache.h"
+#include "esp_heap_caps.h"
+#include <Arduino.h>
+#include <string.h>
+
+static const uint32_t kLetters[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '+', '.', 0x00B0 };
+#define GLYPH_CACHE_SLOTS (sizeof(kLetters) / sizeof(kLetters[0]))
+
+// `font` must stay the first member: the LVGL callbacks get &font back.
+struct CachedFont {
+  lv_font_t        font;
+  const lv_font_t* base;
+  uint8_t*         a8[GLYPH_CACHE_SLOTS];
+};
+
+static CachedFont g_fonts[GLYPH_CACHE_FONTS];
+static int g_font_count = 0;
+static GlyphCacheStats g_stats = {};
+
+static int slot_for(uint32_t letter) {
+  if (letter >= '0' && letter <= '9') return letter - '0';
+  switch (letter) {
+    case '-':    return 10;
+    case '+':    return 11;
+    case '.':    return 12;
+    case 0x00B0: return 13;
+    default:     return -1;
+  }
+}
+
+static bool cached_glyph_dsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t next) {
+  const CachedFont* cf = (const CachedFont*)font;
+  if (!cf->base->get_glyph_dsc(cf->base, dsc, letter, next)) return false;
+  int s = slot_for(letter);
+  if (s >= 0 && cf->a8[s]) dsc->bpp = 8;
+  return true;
+}
+
+static const uint8_t* cached_glyph_bitmap(const lv_font_t* font, uint32_t letter) {
+  const CachedFont* cf = (const CachedFont*)font;
+  int s = slot_for(letter);
+  if (s >= 0 && cf->a8[s]) { g_stats.hits++; return cf->a8[s]; }
+  g_stats.misses++;
+  return cf->base->get_glyph_bitmap(cf->base, letter);
+}
+
+// lv_font_conv bitmaps are packed row-major with no row padding, MSB first.
+static void expand_to_a8(const uint8_t* src, uint8_t bpp, uint32_t n, uint8_t* dst) {
+  uint32_t mask = (1u << bpp) - 1;
+  uint32_t mul = 255 / mask;
+  for (uint32_t p = 0; p < n; p++) {
+    uint32_t bit = p * bpp;
+    uint32_t v = (src[bit >> 3] >> (8 - bpp - (bit & 7))) & mask;
+    dst[p] = (uint8_t)(v * mul);
+  }
+}
+
+const lv_font_t* glyph_cache_wrap(const lv_font_t* base) {
+  if (!base || g_font_count >= GLYPH_CACHE_FONTS) return base;
+  CachedFont& cf = g_fonts[g_font_count];
+  memset(&cf, 0, sizeof(cf));
+  cf.base = base;
+
+  uint32_t glyphs = 0, bytes = 0;
+  for (size_t s = 0; s < GLYPH_CACHE_SLOTS; s++) {
+    lv_font_glyph_dsc_t g;
+    if (!base->get_glyph_dsc(base, &g, kLetters[s], 0)) continue;
+    if (g.bpp != 1 && g.bpp != 2 && g.bpp != 4 && g.bpp != 8) continue;   // 3 bpp is stored as 4 with gaps
+    uint32_t n = (uint32_t)g.box_w * g.box_h;
+    if (n == 0) continue;
+    // The base bitmap (decompressed into LVGL's shared buffer) is only valid
+    // until the next glyph request, so copy it right away.
+    const uint8_t* src = base->get_glyph_bitmap(base, kLetters[s]);
+    if (!src) continue;
+    uint8_t* a8 = (uint8_t*)heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!a8) break;
+    if (g.bpp == 8) memcpy(a8, src, n); else expand_to_a8(src, g.bpp, n, a8);
+    cf.a8[s] = a8;
+    glyphs++; bytes += n;
+  }
+  if (!glyphs) return base;
+
+  cf.font = *base;
+  cf.font.get_glyph_dsc = cached_glyph_dsc;
+  cf.font.get_glyph_bitmap = cached_glyph_bitmap;
+  g_font_count++;
+  g_stats.glyphs += glyphs;
+  g_stats.bytes += bytes;
+  Serial.printf("[font] cached %lu glyphs, %lu bytes (line height %d)\n",
+                (unsigned long)glyphs, (unsigned long)bytes, base->line_height);
+  return &cf.font;
+}
+
+GlyphCacheStats glyph_cache_get_stats() { return g_stats; }
@@ -0,0 +1,22 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+
+// Pre-rasterized glyphs for value fonts. glyph_cache_wrap() returns a copy of
+// `base` whose digits, sign, decimal point and degree sign are served as
+// ready A8 bitmaps from PSRAM (the glyph descriptor reports bpp 8), so the
+// compressed 4-bpp source is expanded once at startup instead of on every
+// repaint. All other glyphs fall through to the base font.
+#define GLYPH_CACHE_FONTS 2
+
+struct GlyphCacheStats {
+  uint32_t hits;     // bitmap requests served from the cache
+  uint32_t misses;   // bitmap requests passed to the base font
+  uint32_t glyphs;   // glyphs held
+  uint32_t bytes;    // PSRAM used
+};
+
+// Call from the LVGL task before the font is used. Returns base if the font
+// table is full or nothing could be cached.
+const lv_font_t* glyph_cache_wrap(const lv_font_t* base);
+GlyphCacheStats glyph_cache_get_stats();
@@ -7,6 +7,7 @@
 #include "esp_lcd_touch.h"
 #include "esp_lcd_gsl3680.h"
 #include "gsl3680_touch.h"
+#include "config.h"
 
 #define CONFIG_LCD_HRES 800
 #define CONFIG_LCD_VRES 1280
@@ -19,6 +20,13 @@ esp_lcd_panel_io_handle_t tp_io_handle;
 uint16_t touch_strength[1];
 uint8_t touch_cnt = 0;
 
+static void (*s_on_int)() = nullptr;
+
+static void IRAM_ATTR tp_isr(esp_lcd_touch_handle_t tp)
+{
+    if (s_on_int) s_on_int();
+}
+
 gsl3680_touch::gsl3680_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin)
 {
     _sda = sda_pin;
@@ -27,8 +35,10 @@ gsl3680_touch::gsl3680_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int
     _int = int_pin;
 }
 
-void gsl3680_touch::begin()
+void gsl3680_touch::begin(void (*on_int)())
 {
+    s_on_int = on_int;
+
     i2c_config_t i2c_conf = {
         .mode = I2C_MODE_MASTER,
         .sda_io_num = (gpio_num_t)_sda,
@@ -52,13 +62,14 @@ void gsl3680_touch::begin()
         .int_gpio_num = (gpio_num_t)_int,
         .levels = {
             .reset = 0,
-            .interrupt = 0,
+            .interrupt = on_int ? TOUCH_INT_ACTIVE_HIGH : 0,
         },
         .flags = {
             .swap_xy = 0,
             .mirror_x = 1,
             .mirror_y = 1,
         },
+        .interrupt_callback = on_int ? tp_isr : NULL,
     };
 
     ESP_LOGI(TAG, "Initialize touch controller gsl3680");
@@ -7,7 +7,8 @@ class gsl3680_touch
 public:
     gsl3680_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin = -1, int8_t int_pin = -1);
 
-    void begin();
+    // on_int, if given, runs in ISR context on every TP_INT edge.
+    void begin(void (*on_int)() = nullptr);
     bool getTouch(uint16_t *x, uint16_t *y);
     void set_rotation(uint8_t r);
 
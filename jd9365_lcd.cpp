@@ -14,6 +14,7 @@
 
 #include "esp_lcd_jd9365.h"
 #include "jd9365_lcd.h"
+#include "config.h"
 
 #define LCD_H_RES 800
 #define LCD_V_RES 1280
@@ -88,6 +89,8 @@ void jd9365_lcd::begin()
 
     // 创建JD9365控制面板
     esp_lcd_dpi_panel_config_t dpi_config = JD9365_800_1280_PANEL_60HZ_DPI_CONFIG(MIPI_DPI_PX_FORMAT);
+    // 双缓冲时 LVGL 直接在后台帧缓冲区绘制 (DISPLAY_DIRECT_MODE)
+    dpi_config.num_fbs = DISPLAY_NUM_FBS;
 
     jd9365_vendor_config_t vendor_config = {
         .mipi_config = {
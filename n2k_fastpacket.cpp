@@ -0,0 +1,71 @@
+#include "n2k_fastpacket.h"
+#include <string.h>
+
+void n2k_fp_init(N2kFastPacket& fp) { memset(&fp, 0, sizeof(fp)); }
+
+static void release(N2kFastPacket& fp, N2kFastPacketSlot& s, bool abandoned) {
+  if (abandoned) fp.stats.incomplete++;
+  s.used = false;
+}
+
+// Returns a slot for a new session: a free one, else a stale one, else the oldest.
+static N2kFastPacketSlot& claim(N2kFastPacket& fp, uint32_t now_ms) {
+  N2kFastPacketSlot* oldest = &fp.slots[0];
+  for (N2kFastPacketSlot& s : fp.slots) {
+    if (!s.used) return s;
+    if (now_ms - s.last_ms > N2K_FP_TIMEOUT_MS) { release(fp, s, true); return s; }
+    if ((int32_t)(s.last_ms - oldest->last_ms) < 0) oldest = &s;
+  }
+  fp.stats.evicted++;
+  release(fp, *oldest, true);
+  return *oldest;
+}
+
+static N2kFastPacketSlot* find(N2kFastPacket& fp, uint32_t pgn, uint8_t src, uint8_t seq) {
+  for (N2kFastPacketSlot& s : fp.slots)
+    if (s.used && s.pgn == pgn && s.src == src && s.seq == seq) return &s;
+  return nullptr;
+}
+
+bool n2k_fp_feed(N2kFastPacket& fp, uint32_t pgn, uint8_t src, const uint8_t* d, uint8_t len,
+                 uint32_t now_ms, N2kMessage& msg) {
+  if (len < 2) { fp.stats.dropped++; return false; }
+  uint8_t seq   = d[0] >> 5;
+  uint8_t frame = d[0] & 0x1F;
+  N2kFastPacketSlot* s = find(fp, pgn, src, seq);
+
+  if (frame == 0) {
+    uint16_t total = d[1];
+    if (total == 0 || total > N2K_FP_MAX_LEN) { fp.stats.dropped++; return false; }
+    // A new first frame supersedes any unfinished session of that sender and
+    // PGN, including a restart of the same sequence counter.
+    for (N2kFastPacketSlot& o : fp.slots)
+      if (o.used && o.pgn == pgn && o.src == src) release(fp, o, true);
+    s = &claim(fp, now_ms);
+    s->used = true; s->src = src; s->seq = seq; s->pgn = pgn;
+    s->total = total; s->got = 0; s->next_frame = 1;
+    uint16_t n = (uint16_t)(len - 2);
+    if (n > total) n = total;
+    memcpy(s->buf, d + 2, n);
+    s->got = n;
+  } else {
+    if (!s) { fp.stats.dropped++; return false; }
+    if (frame != s->next_frame || now_ms - s->last_ms > N2K_FP_TIMEOUT_MS) {
+      fp.stats.dropped++;
+      release(fp, *s, true);
+      return false;
+    }
+    uint16_t n = (uint16_t)(len - 1);
+    if (n > s->total - s->got) n = (uint16_t)(s->total - s->got);
+    memcpy(s->buf + s->got, d + 1, n);
+    s->got = (uint16_t)(s->got + n);
+    s->next_frame++;
+  }
+  s->last_ms = now_ms;
+
+  if (s->got < s->total) return false;
+  fp.stats.completed++;
+  msg.pgn = s->pgn; msg.src = s->src; msg.len = s->total; msg.data = s->buf;
+  release(fp, *s, false);
+  return true;
+}
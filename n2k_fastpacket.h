@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+// NMEA 2000 fast-packet reassembly. A session is keyed by (source, PGN,
+// sequence counter); frame 0 carries the total length and 6 payload bytes,
+// frames 1..n carry 7 bytes each. All storage is preallocated in the struct.
+#define N2K_FP_MAX_LEN    223   // 6 + 31 * 7
+#define N2K_FP_SLOTS      8
+#define N2K_FP_TIMEOUT_MS 750   // sessions idle this long are evicted
+
+struct N2kFastPacketStats {
+  uint32_t completed;
+  uint32_t dropped;      // frames that fit no session: orphan, gap, bad length
+  uint32_t incomplete;   // sessions abandoned before their last frame
+  uint32_t evicted;      // live sessions pushed out because all slots were busy
+};
+
+struct N2kFastPacketSlot {
+  bool     used;
+  uint8_t  src;
+  uint8_t  seq;
+  uint8_t  next_frame;
+  uint32_t pgn;
+  uint16_t total;
+  uint16_t got;
+  uint32_t last_ms;
+  uint8_t  buf[N2K_FP_MAX_LEN];
+};
+
+struct N2kFastPacket {
+  N2kFastPacketSlot  slots[N2K_FP_SLOTS];
+  N2kFastPacketStats stats;
+};
+
+struct N2kMessage { uint32_t pgn; uint8_t src; uint16_t len; const uint8_t* data; };
+
+void n2k_fp_init(N2kFastPacket& fp);
+// Feeds one CAN frame of a fast-packet PGN. Returns true when it completed a
+// message; msg.data points into fp and is only valid until the next feed.
+bool n2k_fp_feed(N2kFastPacket& fp, uint32_t pgn, uint8_t src, const uint8_t* d, uint8_t len,
+                 uint32_t now_ms, N2kMessage& msg);
@@ -0,0 +1,145 @@
+#include "perf_hud.h"
+#include "config.h"
+#include "display_driver.h"
+#include "can_bus.h"
+#include "sdlog.h"
+#include "esp_heap_caps.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+enum { HUD_FPS, HUD_CPU, HUD_HEAP, HUD_CAN, HUD_SD, HUD_LINES };
+
+static lv_obj_t*   s_panel = nullptr;
+static lv_obj_t*   s_line[HUD_LINES];
+static char        s_text[HUD_LINES][64];
+static lv_timer_t* s_timer = nullptr;
+
+// Previous sample, for per-window rates
+static uint32_t s_prev_ms;
+static display_render_stats_t s_prev_render;
+static display_flush_stats_t  s_prev_flush;
+static uint32_t s_prev_can_frames;
+
+#if configGENERATE_RUN_TIME_STATS
+static uint32_t s_prev_total;
+static uint32_t s_prev_idle[portNUM_PROCESSORS];
+#endif
+
+static void fmt_bytes(char* out, size_t cap, size_t b) {
+  if (b >= 10u * 1024 * 1024) snprintf(out, cap, "%uM", (unsigned)(b >> 20));
+  else if (b >= 10u * 1024)   snprintf(out, cap, "%uk", (unsigned)(b >> 10));
+  else                        snprintf(out, cap, "%u", (unsigned)b);
+}
+
+static int fmt_heap(char* out, size_t cap, const char* name, uint32_t caps) {
+  char f[8], l[8];
+  fmt_bytes(f, sizeof(f), heap_caps_get_free_size(caps));
+  fmt_bytes(l, sizeof(l), heap_caps_get_largest_free_block(caps));
+  return snprintf(out, cap, "%s %s/%s  ", name, f, l);
+}
+
+static void set_line(int i) { lv_label_set_text_static(s_line[i], s_text[i]); }
+
+static void hud_update(lv_timer_t* t) {
+  (void)t;
+  uint32_t now = millis();
+  uint32_t dt = now - s_prev_ms;
+  if (dt == 0) return;
+  s_prev_ms = now;
+
+  display_render_stats_t r;
+  display_flush_stats_t fl;
+  display_get_render_stats(&r);
+  display_get_flush_stats(&fl);
+  uint32_t frames = r.frames - s_prev_render.frames;
+  uint32_t frame_ms = frames ? (r.total_ms - s_prev_render.total_ms) / frames : 0;
+  uint32_t flush_us = frames ? (fl.flush_us - s_prev_flush.flush_us) / frames : 0;
+  snprintf(s_text[HUD_FPS], sizeof(s_text[0]), "FPS %lu  frame %lu ms  flush %lu.%lu ms",
+           (unsigned long)(frames * 1000 / dt), (unsigned long)frame_ms,
+           (unsigned long)(flush_us / 1000), (unsigned long)(flush_us / 100 % 10));
+  s_prev_render = r;
+  s_prev_flush = fl;
+  set_line(HUD_FPS);
+
+#if configGENERATE_RUN_TIME_STATS
+  // Load = 1 - idle task share of the window, per core
+  uint32_t total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+  uint32_t span = total - s_prev_total;
+  s_prev_total = total;
+  int n = snprintf(s_text[HUD_CPU], sizeof(s_text[0]), "CPU");
+  for (int c = 0; c < portNUM_PROCESSORS; c++) {
+    uint32_t idle = (uint32_t)ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(c));
+    uint32_t busy = span ? 100 - (uint32_t)((uint64_t)(idle - s_prev_idle[c]) * 100 / span) : 0;
+    s_prev_idle[c] = idle;
+    n += snprintf(s_text[HUD_CPU] + n, sizeof(s_text[0]) - n, "  %d: %lu%%", c, (unsigned long)busy);
+  }
+#else
+  snprintf(s_text[HUD_CPU], sizeof(s_text[0]), "CPU n/a (no FreeRTOS run-time stats)");
+#endif
+  set_line(HUD_CPU);
+
+  // free/largest block
+  int n2 = fmt_heap(s_text[HUD_HEAP], sizeof(s_text[0]), "int", MALLOC_CAP_INTERNAL);
+  n2 += fmt_heap(s_text[HUD_HEAP] + n2, sizeof(s_text[0]) - n2, "dma", MALLOC_CAP_DMA);
+  fmt_heap(s_text[HUD_HEAP] + n2, sizeof(s_text[0]) - n2, "psram", MALLOC_CAP_SPIRAM);
+  set_line(HUD_HEAP);
+
+  CanBridgeStats c = canbridge_get_stats();
+  snprintf(s_text[HUD_CAN], sizeof(s_text[0]), "CAN %lu/s  queue %lu (max %lu)  drops %lu",
+           (unsigned long)((c.frames - s_prev_can_frames) * 1000ull / dt), (unsigned long)c.queued,
+           (unsigned long)c.high_water, (unsigned long)c.overflows);
+  s_prev_can_frames = c.frames;
+  set_line(HUD_CAN);
+
+  SdLogStats sd = sdlog_get_stats();
+  char backlog[8];
+  fmt_bytes(backlog, sizeof(backlog), sd.backlog_bytes);
+  snprintf(s_text[HUD_SD], sizeof(s_text[0]), "SD backlog %s  dropped %lu  flush %lu ms",
+           backlog, (unsigned long)sd.dropped_bytes, (unsigned long)(sd.last_flush_us / 1000));
+  set_line(HUD_SD);
+}
+
+static void hud_create() {
+  s_panel = lv_obj_create(lv_layer_top());
+  lv_obj_remove_style_all(s_panel);
+  lv_obj_set_size(s_panel, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+  lv_obj_set_pos(s_panel, 8, 8);
+  lv_obj_set_style_bg_color(s_panel, lv_color_black(), 0);
+  lv_obj_set_style_bg_opa(s_panel, LV_OPA_70, 0);
+  lv_obj_set_style_pad_all(s_panel, 6, 0);
+  lv_obj_set_flex_flow(s_panel, LV_FLEX_FLOW_COLUMN);
+  lv_obj_clear_flag(s_panel, LV_OBJ_FLAG_CLICKABLE);   // never steals touches
+  for (int i = 0; i < HUD_LINES; i++) {
+    s_text[i][0] = '\0';
+    s_line[i] = lv_label_create(s_panel);
+    lv_obj_set_style_text_font(s_line[i], LV_FONT_DEFAULT, 0);
+    lv_obj_set_style_text_color(s_line[i], lv_color_white(), 0);
+    lv_label_set_text_static(s_line[i], s_text[i]);
+  }
+}
+
+void perf_hud_enable(bool enable) {
+  if (enable == perf_hud_enabled()) return;
+  if (!enable) {
+    lv_timer_del(s_timer);
+    s_timer = nullptr;
+    lv_obj_add_flag(s_panel, LV_OBJ_FLAG_HIDDEN);
+    return;
+  }
+  if (!s_panel) hud_create();
+  lv_obj_clear_flag(s_panel, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_move_foreground(s_panel);
+  // Baseline first so the first rates cover one whole period
+  s_prev_ms = millis();
+  display_get_render_stats(&s_prev_render);
+  display_get_flush_stats(&s_prev_flush);
+  s_prev_can_frames = canbridge_get_stats().frames;
+#if configGENERATE_RUN_TIME_STATS
+  s_prev_total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+  for (int c = 0; c < portNUM_PROCESSORS; c++)
+    s_prev_idle[c] = (uint32_t)ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(c));
+#endif
+  s_timer = lv_timer_create(hud_update, PERF_HUD_PERIOD_MS, nullptr);
+}
+
+bool perf_hud_enabled() { return s_timer != nullptr; }
@@ -0,0 +1,10 @@
+#pragma once
+#include <lvgl.h>
+
+// Small stats panel on lv_layer_top(), refreshed by an LVGL timer every
+// PERF_HUD_PERIOD_MS:
+//   render FPS, frame and flush time / CPU load per core / heap free and
+//   largest block (internal, DMA, PSRAM) / CAN rate, queue, drops / SD backlog
+// LVGL task only.
+void perf_hud_enable(bool enable);
+bool perf_hud_enabled();
@@ -0,0 +1,74 @@
+#include "perf_trace.h"
+
+#if PERF_TRACE_ENABLE
+#include <string.h>
+
+// Bucket i < 8 holds exactly i cycles; above that each power of two
+// [2^m, 2^(m+1)) is split into 8 equal buckets.
+#define PERF_SUB     8
+#define PERF_BUCKETS ((32 - 2) * PERF_SUB)
+
+struct PerfHist {
+  uint32_t n;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t bucket[PERF_BUCKETS];
+};
+
+static PerfHist g_hist[PERF_POINT_COUNT];
+static const char* const kNames[PERF_POINT_COUNT] = {
+  "lv_timer", "refr", "flush", "bounce_copy", "draw_bitmap",
+};
+
+static inline uint32_t bucket_of(uint32_t v) {
+  if (v < PERF_SUB) return v;
+  uint32_t m = 31 - __builtin_clz(v);
+  return (m - 2) * PERF_SUB + ((v >> (m - 3)) & (PERF_SUB - 1));
+}
+
+// Largest value that lands in bucket i
+static uint32_t bucket_top(uint32_t i) {
+  if (i < PERF_SUB) return i;
+  uint32_t m = i / PERF_SUB + 2, sub = i % PERF_SUB;
+  return (((PERF_SUB + sub + 1) << (m - 3)) - 1);
+}
+
+void perf_record(PerfPoint p, uint32_t cycles) {
+  PerfHist& h = g_hist[p];
+  h.n++;
+  h.sum += cycles;
+  if (cycles > h.max) h.max = cycles;
+  h.bucket[bucket_of(cycles)]++;
+}
+
+static uint32_t percentile(const PerfHist& h, uint32_t pct) {
+  uint64_t want = ((uint64_t)h.n * pct + 99) / 100;   // rank, 1-based
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < PERF_BUCKETS; i++) {
+    seen += h.bucket[i];
+    if (seen >= want) return bucket_top(i) < h.max ? bucket_top(i) : h.max;
+  }
+  return h.max;
+}
+
+void perf_trace_dump(Print& out) {
+  float mhz = (float)getCpuFrequencyMhz();
+  out.println("[perf] point           n      mean     p50     p95     p99     max  (us)");
+  for (int p = 0; p < PERF_POINT_COUNT; p++) {
+    PerfHist h = g_hist[p];   // snapshot; the writer may be mid-update
+    if (!h.n) continue;
+    out.printf("[perf] %-11s %7lu %8.1f %7.1f %7.1f %7.1f %7.1f\n", kNames[p], (unsigned long)h.n,
+               (double)(h.sum / (float)h.n / mhz), (double)(percentile(h, 50) / mhz),
+               (double)(percentile(h, 95) / mhz), (double)(percentile(h, 99) / mhz),
+               (double)(h.max / mhz));
+  }
+}
+
+void perf_trace_reset() { memset(g_hist, 0, sizeof(g_hist)); }
+
+#else
+
+void perf_trace_dump(Print& out) { out.println("[perf] tracing compiled out (PERF_TRACE_ENABLE=0)"); }
+void perf_trace_reset() {}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Scoped cycle-count probes feeding fixed-bucket histograms: 8 log-spaced
+// buckets per power of two (<= 12.5% wide), so p50/p95/p99 come out of a
+// few KB of counters. One writer per point (the render task); dumps read
+// without locking and may be off by a sample.
+//
+//   { PERF_SCOPE(PERF_FLUSH); ...; }
+//
+// With PERF_TRACE_ENABLE=0 the probes expand to nothing.
+enum PerfPoint {
+  PERF_LV_TIMER,      // lv_timer_handler()
+  PERF_REFR,          // display refresh timer: render + flush of one frame
+  PERF_FLUSH,         // flush_cb
+  PERF_BOUNCE_COPY,   // memcpy into the bounce buffer
+  PERF_DRAW_BITMAP,   // draw_bitmap_retry()
+  PERF_POINT_COUNT
+};
+
+#if PERF_TRACE_ENABLE
+#include "esp_cpu.h"
+
+void perf_record(PerfPoint p, uint32_t cycles);
+
+struct PerfScope {
+  PerfPoint point;
+  uint32_t  c0;
+  explicit PerfScope(PerfPoint p) : point(p), c0(esp_cpu_get_cycle_count()) {}
+  ~PerfScope() { perf_record(point, esp_cpu_get_cycle_count() - c0); }
+};
+
+#define PERF_CAT2(a, b) a##b
+#define PERF_CAT(a, b)  PERF_CAT2(a, b)
+#define PERF_SCOPE(p)   PerfScope PERF_CAT(perf_scope_, __LINE__)(p)
+#else
+#define PERF_SCOPE(p)   do {} while (0)
+#endif
+
+// Prints "[perf] <point> n mean p50 p95 p99 max" in microseconds, one line
+// per point that has samples (or a note that tracing is compiled out).
+void perf_trace_dump(Print& out);
+void perf_trace_reset();
@@ -0,0 +1,67 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// PGN -> decoder routing, built at compile time.
+// Routes are listed once in a constexpr array and turned into an open-addressed
+// hash table (load factor <= 1/2, Fibonacci hashing, linear probing), so both
+// hits and unknown PGNs resolve in O(1) expected probes.
+
+typedef void (*PgnDecoder)(uint8_t src, const uint8_t* d, uint16_t len);
+
+struct PgnRoute {
+  uint32_t   pgn;
+  uint16_t   min_len;      // shorter payloads are ignored
+  bool       fast_packet;  // frames go through n2k_fp_feed first
+  PgnDecoder decode;
+};
+
+template <size_t N>
+constexpr bool pgn_routes_unique(const PgnRoute (&r)[N]) {
+  for (size_t i = 0; i < N; i++)
+    for (size_t j = i + 1; j < N; j++)
+      if (r[i].pgn == r[j].pgn) return false;
+  return true;
+}
+
+template <size_t N>
+class PgnDispatch {
+  static constexpr unsigned bits_for(size_t n) {
+    unsigned b = 1;
+    while (((size_t)1 << b) < 2 * n) b++;
+    return b;
+  }
+  static constexpr unsigned kBits = bits_for(N);
+  static constexpr size_t   kSlots = (size_t)1 << kBits;
+  static constexpr uint32_t hash(uint32_t pgn) { return (uint32_t)(pgn * 2654435761u) >> (32 - kBits); }
+
+public:
+  constexpr explicit PgnDispatch(const PgnRoute (&routes)[N]) : routes_{}, slots_{} {
+    for (size_t i = 0; i < kSlots; i++) slots_[i] = -1;
+    for (size_t i = 0; i < N; i++) {
+      routes_[i] = routes[i];
+      uint32_t h = hash(routes[i].pgn);
+      while (slots_[h] >= 0) h = (h + 1) & (kSlots - 1);
+      slots_[h] = (int16_t)i;
+    }
+  }
+
+  // Index of the route for pgn, or -1 when the PGN is not registered.
+  int index_of(uint32_t pgn) const {
+    for (uint32_t h = hash(pgn);; h = (h + 1) & (kSlots - 1)) {
+      int16_t i = slots_[h];
+      if (i < 0) return -1;
+      if (routes_[i].pgn == pgn) return i;
+    }
+  }
+  const PgnRoute* find(uint32_t pgn) const {
+    int i = index_of(pgn);
+    return i < 0 ? nullptr : &routes_[i];
+  }
+  const PgnRoute& route(size_t i) const { return routes_[i]; }
+  static constexpr size_t size() { return N; }
+
+private:
+  PgnRoute routes_[N];
+  int16_t  slots_[kSlots];
+};
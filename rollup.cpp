@@ -0,0 +1,147 @@
+#include "rollup.h"
+#include "config.h"
+#include "tslog_codec.h"
+#include "esp_heap_caps.h"
+#include <float.h>
+#include <math.h>
+
+// Snapshot layout (native byte order, same device writes and reads it):
+//   u32 magic, u32 tier count, then per tier u32 points, interval_ms, head,
+//   then per tier values[points], mins[points], maxs[points], counts[points],
+//   then u32 CRC-32 of everything before it.
+#define ROLLUP_SNAP_MAGIC 0x31445252u   // "RRD1"
+
+static void bucket_reset(RollupBucket& b, uint32_t now_ms) {
+  b.min = FLT_MAX; b.max = -FLT_MAX; b.sum = 0; b.count = 0; b.start_ms = now_ms;
+}
+
+void rollup_init(RollupSignal& r, const char* name, const SeriesConfig* tiers, uint8_t tier_count, bool log_sd) {
+  if (tier_count > ROLLUP_MAX_TIERS) tier_count = ROLLUP_MAX_TIERS;
+  r.name = name;
+  r.tier_count = tier_count;
+  r.log_sd = log_sd;
+  r.last_snapshot_ms = 0;
+  for (uint8_t t = 0; t < tier_count; t++) {
+    series_init(r.tiers[t], tiers[t]);
+    bucket_reset(r.acc[t], 0);
+    snprintf(r.log_name[t], sizeof(r.log_name[t]), "%s_%s", name, tiers[t].name);
+    if (log_sd) sdlog_open_series(r.log_name[t]);
+  }
+}
+
+void rollup_add(RollupSignal& r, uint32_t now_ms, float v) {
+  for (uint8_t t = 0; t < r.tier_count; t++) {
+    RollupBucket& b = r.acc[t];
+    if (b.count == 0) b.start_ms = now_ms;
+    if (v < b.min) b.min = v;
+    if (v > b.max) b.max = v;
+    b.sum += v;
+    b.count++;
+
+    if (now_ms - b.start_ms < r.tiers[t].cfg.interval_ms) continue;
+    float mean = b.sum / b.count;
+    series_store_bucket(r.tiers[t], now_ms, mean, b.min, b.max, b.count);
+    if (r.log_sd) sdlog_append(r.log_name[t], now_ms, mean);
+    bucket_reset(b, now_ms);
+  }
+}
+
+static size_t snapshot_size(const RollupSignal& r) {
+  size_t n = 8 + 4;
+  for (uint8_t t = 0; t < r.tier_count; t++)
+    n += 12 + r.tiers[t].cfg.points * (3 * sizeof(float) + sizeof(uint16_t));
+  return n;
+}
+
+static void snapshot_path(const RollupSignal& r, char* out, size_t cap) {
+  snprintf(out, cap, "/%s.rrd", r.name);
+}
+
+bool rollup_snapshot(RollupSignal& r) {
+  for (uint8_t t = 0; t < r.tier_count; t++) {
+    const SeriesRuntime& s = r.tiers[t];
+    if (!s.values || !s.mins || !s.maxs || !s.counts) return false;
+  }
+  size_t len = snapshot_size(r);
+  uint8_t* buf = (uint8_t*)heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf) buf = (uint8_t*)malloc(len);
+  if (!buf) return false;
+
+  uint8_t* p = buf;
+  auto put = [&p](const void* src, size_t n) { memcpy(p, src, n); p += n; };
+  uint32_t hdr[2] = { ROLLUP_SNAP_MAGIC, r.tier_count };
+  put(hdr, sizeof(hdr));
+  for (uint8_t t = 0; t < r.tier_count; t++) {
+    const SeriesRuntime& s = r.tiers[t];
+    uint32_t shape[3] = { s.cfg.points, s.cfg.interval_ms, s.head };
+    put(shape, sizeof(shape));
+  }
+  for (uint8_t t = 0; t < r.tier_count; t++) {
+    const SeriesRuntime& s = r.tiers[t];
+    put(s.values, s.cfg.points * sizeof(float));
+    put(s.mins,   s.cfg.points * sizeof(float));
+    put(s.maxs,   s.cfg.points * sizeof(float));
+    put(s.counts, s.cfg.points * sizeof(uint16_t));
+  }
+  uint32_t crc = tsl_crc32(0, buf, p - buf);
+  put(&crc, 4);
+
+  char path[32];
+  snapshot_path(r, path, sizeof(path));
+  return sdlog_submit_file(path, buf, len);
+}
+
+bool rollup_restore(RollupSignal& r) {
+  for (uint8_t t = 0; t < r.tier_count; t++) {
+    const SeriesRuntime& s = r.tiers[t];
+    if (!s.values || !s.mins || !s.maxs || !s.counts) return false;
+  }
+  size_t len = snapshot_size(r);
+  uint8_t* buf = (uint8_t*)heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf) buf = (uint8_t*)malloc(len);
+  if (!buf) return false;
+
+  uint32_t t0 = millis();
+  char path[32];
+  snapshot_path(r, path, sizeof(path));
+  bool ok = sdlog_read_file(path, buf, len) == len;
+  uint32_t crc = 0;
+  if (ok) { memcpy(&crc, buf + len - 4, 4); ok = crc == tsl_crc32(0, buf, len - 4); }
+
+  const uint8_t* p = buf;
+  auto get = [&p](void* dst, size_t n) { memcpy(dst, p, n); p += n; };
+  uint32_t hdr[2] = {};
+  uint32_t heads[ROLLUP_MAX_TIERS] = {};
+  if (ok) {
+    get(hdr, sizeof(hdr));
+    ok = hdr[0] == ROLLUP_SNAP_MAGIC && hdr[1] == r.tier_count;
+  }
+  for (uint8_t t = 0; ok && t < r.tier_count; t++) {
+    uint32_t shape[3];
+    get(shape, sizeof(shape));
+    const SeriesConfig& c = r.tiers[t].cfg;
+    ok = shape[0] == c.points && shape[1] == c.interval_ms && shape[2] < c.points;
+    heads[t] = shape[2];
+  }
+  if (ok) {
+    for (uint8_t t = 0; t < r.tier_count; t++) {
+      SeriesRuntime& s = r.tiers[t];
+      get(s.values, s.cfg.points * sizeof(float));
+      get(s.mins,   s.cfg.points * sizeof(float));
+      get(s.maxs,   s.cfg.points * sizeof(float));
+      get(s.counts, s.cfg.points * sizeof(uint16_t));
+      s.head = heads[t];
+      series_store_bucket(s, 0, NAN, NAN, NAN, 0);
+    }
+    Serial.printf("[SD] restored %s (%u tiers) in %lu ms\n", r.name, r.tier_count,
+                  (unsigned long)(millis() - t0));
+  }
+  free(buf);
+  return ok;
+}
+
+void rollup_tick(RollupSignal& r, uint32_t now_ms) {
+  if (!r.log_sd || now_ms - r.last_snapshot_ms < ROLLUP_SNAPSHOT_MS) return;
+  r.last_snapshot_ms = now_ms;
+  rollup_snapshot(r);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+#include "sdlog.h"
+
+#define ROLLUP_MAX_TIERS 4
+
+// Running aggregate of the bucket that is currently filling.
+struct RollupBucket { float min, max, sum; uint32_t count; uint32_t start_ms; };
+
+// One signal with several resolutions (e.g. 3.5 s / 21 s / 84 s). Every tier
+// aggregates the raw samples independently into min/max/mean/count buckets
+// and pushes a finished bucket into its SeriesRuntime ring, so an update is
+// O(tiers) regardless of bucket length. Tier "6h" of signal "battery_v" logs
+// to battery_v_6h on SD.
+struct RollupSignal {
+  const char*   name;
+  uint8_t       tier_count;
+  bool          log_sd;
+  SeriesRuntime tiers[ROLLUP_MAX_TIERS];
+  RollupBucket  acc[ROLLUP_MAX_TIERS];
+  char          log_name[ROLLUP_MAX_TIERS][24];
+  uint32_t      last_snapshot_ms;
+};
+
+void rollup_init(RollupSignal& r, const char* name, const SeriesConfig* tiers, uint8_t tier_count, bool log_sd);
+void rollup_add(RollupSignal& r, uint32_t now_ms, float v);
+
+// Warm start: the tier rings are periodically written to /<name>.rrd and read
+// back at boot. The power-off gap is not known (no RTC), so a restore appends
+// one empty bucket (count 0, NaN) to every tier to mark the break.
+bool rollup_snapshot(RollupSignal& r);
+bool rollup_restore(RollupSignal& r);
+// Snapshots once every ROLLUP_SNAPSHOT_MS; call from the context that feeds r.
+void rollup_tick(RollupSignal& r, uint32_t now_ms);
@@ -0,0 +1,25 @@
+#include "rotate_rgb565.h"
+#include <stddef.h>
+
+// 32x32 px tiles: the strided source column walk stays within 32 rows
+// (2 KB of source lines) while every destination row is written contiguously.
+#define ROTATE_TILE 32
+
+void rotate90_rgb565(const uint16_t* src, int w, int h, int src_stride,
+                     uint16_t* dst, int dst_stride)
+{
+    for (int ty = 0; ty < h; ty += ROTATE_TILE) {
+        int ye = (ty + ROTATE_TILE < h) ? ty + ROTATE_TILE : h;
+        for (int tx = 0; tx < w; tx += ROTATE_TILE) {
+            int xe = (tx + ROTATE_TILE < w) ? tx + ROTATE_TILE : w;
+            for (int x = tx; x < xe; x++) {
+                const uint16_t* s = src + (size_t)ty * src_stride + x;
+                uint16_t* d = dst + (size_t)(w - 1 - x) * dst_stride + ty;
+                for (int y = ty; y < ye; y++) {
+                    *d++ = *s;
+                    s += src_stride;
+                }
+            }
+        }
+    }
+}
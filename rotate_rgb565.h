@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Rotates a w x h RGB565 block by 90° so that src(x, y) lands on dst(y, w-1-x),
+// i.e. the same mapping LVGL's sw_rotate uses for LV_DISP_ROT_90.
+// dst points at the top-left of the h x w destination block. Strides are in pixels.
+void rotate90_rgb565(const uint16_t* src, int w, int h, int src_stride,
+                     uint16_t* dst, int dst_stride);
+#ifdef __cplusplus
+}
+#endif
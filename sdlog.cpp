@@ -2,13 +2,192 @@
 #include "config.h"
 #if USE_SD_MMC
   #include <SD_MMC.h>
+  #define SD_FS SD_MMC
 #else
   #include <SD.h>
   #include <SPI.h>
+  #define SD_FS SD
 #endif
 #include "esp_heap_caps.h"
+#include "tslog_codec.h"
+
+// Samples are formatted into per-series RAM buffers; a low-priority writer task
+// keeps the files open and appends whole buffers when they pass
+// SDLOG_FLUSH_BYTES or their oldest line is SDLOG_FLUSH_AGE_MS old. Each
+// series has two buffers so producers keep appending while one is written.
+// In the binary format samples first go into the channel's open .tsl block.
+// Once it holds SDLOG_TSL_BLOCK_SAMPLES samples (or fills up, or sdlog_flush()
+// is called) producers switch to the channel's second encoder and the writer
+// seals the finished block (header and CRC) and copies it into the buffer.
+struct LogChannel {
+  char     name[24];
+  File     file;
+  bool     opened;
+  char*    buf[2];
+  uint8_t  fill;       // buffer producers append to; the other one is drained
+  size_t   used;
+  uint32_t first_ms;   // when the oldest unflushed line was added
+#if SDLOG_FORMAT
+  TslEncoder* enc[2];
+  uint8_t  cur;        // encoder producers add to
+  bool     pending;    // enc[cur ^ 1] holds a finished block for the writer
+#endif
+};
 
 static bool g_sd_ok = false;
+static LogChannel g_ch[SDLOG_MAX_SERIES];
+static int g_ch_count = 0;
+static int g_ch_cap = 0;   // channels whose buffers (and encoder) were allocated
+static portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t g_writer = nullptr;
+static volatile bool g_force_flush = false;
+static SdLogStats g_stats = {};   // guarded by g_mux
+
+// Whole-file replacements queued for the writer (ring snapshots).
+#define SDLOG_FILE_JOBS 4
+struct FileJob { char path[32]; void* buf; size_t len; };
+static FileJob g_jobs[SDLOG_FILE_JOBS];
+static int g_job_count = 0;
+
+static String file_for(const char* measurement) {
+  String p = "/"; p += measurement; p += SDLOG_FORMAT ? ".tsl" : ".csv"; return p;
+}
+
+// Caller holds g_mux.
+static LogChannel* channel_for(const char* measurement, bool create) {
+  for (int i = 0; i < g_ch_count; i++) if (strcmp(g_ch[i].name, measurement) == 0) return &g_ch[i];
+  if (!create || g_ch_count >= g_ch_cap) return nullptr;
+  LogChannel& c = g_ch[g_ch_count];
+  if (!c.buf[0] || !c.buf[1]) return nullptr;
+#if SDLOG_FORMAT
+  if (!c.enc[0] || !c.enc[1]) return nullptr;
+  tsl_enc_reset(*c.enc[0]); tsl_enc_reset(*c.enc[1]);
+  c.cur = 0; c.pending = false;
+#endif
+  strlcpy(c.name, measurement, sizeof(c.name));
+  c.used = 0; c.fill = 0; c.opened = false;
+  g_ch_count++;
+  return &c;
+}
+
+static bool writer_open(LogChannel& c) {
+  c.file = SD_FS.open(file_for(c.name), FILE_APPEND);
+  if (!c.file) return false;
+  if (!SDLOG_FORMAT && c.file.size() == 0) c.file.println("ms,value");
+  c.opened = true;
+  return true;
+}
+
+// Caller holds g_mux. Copies `n` bytes into the fill buffer; returns false and
+// counts a drop when they do not fit.
+static bool channel_put(LogChannel& c, const void* p, size_t n) {
+  if (c.used + n > SDLOG_BUF_BYTES) { g_stats.dropped_bytes += n; return false; }
+  if (c.used == 0) c.first_ms = millis();
+  memcpy(c.buf[c.fill] + c.used, p, n);
+  c.used += n;
+  return true;
+}
+
+#if SDLOG_FORMAT
+// Seals the block producers handed over (and, on force, the open one) and
+// queues it for the file. Sealing checksums the whole block, so it runs here
+// on the idle encoder rather than inside g_mux.
+static void writer_seal(LogChannel& c, bool force) {
+  for (;;) {
+    portENTER_CRITICAL(&g_mux);
+    if (force && !c.pending && c.enc[c.cur]->count) { c.pending = true; c.cur ^= 1; force = false; }
+    TslEncoder* e = c.pending ? c.enc[c.cur ^ 1] : nullptr;
+    portEXIT_CRITICAL(&g_mux);
+    if (!e) return;
+    size_t n = tsl_enc_seal(*e);
+    portENTER_CRITICAL(&g_mux);
+    if (n) channel_put(c, e->block, n);
+    portEXIT_CRITICAL(&g_mux);
+    tsl_enc_reset(*e);
+    portENTER_CRITICAL(&g_mux);
+    c.pending = false;
+    portEXIT_CRITICAL(&g_mux);
+  }
+}
+#endif
+
+static void writer_flush_channel(LogChannel& c, bool force) {
+  uint32_t now = millis();
+  portENTER_CRITICAL(&g_mux);
+  bool due = c.used && (force || c.used >= SDLOG_FLUSH_BYTES || now - c.first_ms >= SDLOG_FLUSH_AGE_MS);
+  char* out = nullptr; size_t n = 0;
+  if (due) { out = c.buf[c.fill]; n = c.used; c.fill ^= 1; c.used = 0; }
+  portEXIT_CRITICAL(&g_mux);
+  if (!due) return;
+
+  uint32_t t0 = micros();
+  bool open = c.opened || writer_open(c);
+  size_t written = 0;
+  if (open) {
+    written = c.file.write((const uint8_t*)out, n);
+    c.file.flush();
+    // A short write usually means the card went away; reopen next time
+    if (written < n) { c.file.close(); c.opened = false; }
+  }
+  uint32_t us = micros() - t0;
+  portENTER_CRITICAL(&g_mux);
+  g_stats.dropped_bytes += n - written;
+  if (open) {
+    g_stats.flushes++;
+    g_stats.flushed_bytes += written;
+    g_stats.last_flush_us = us;
+    g_stats.total_flush_us += us;
+    if (us > g_stats.max_flush_us) g_stats.max_flush_us = us;
+  }
+  portEXIT_CRITICAL(&g_mux);
+}
+
+static void writer_write_file(const FileJob& j) {
+  char tmp[40];
+  snprintf(tmp, sizeof(tmp), "%s.tmp", j.path);
+  File f = SD_FS.open(tmp, FILE_WRITE);
+  bool ok = f && f.write((const uint8_t*)j.buf, j.len) == j.len;
+  if (f) f.close();
+  // FAT rename does not overwrite; a crash in between leaves the .tmp, which
+  // readers fall back to.
+  if (ok) { SD_FS.remove(j.path); ok = SD_FS.rename(tmp, j.path); }
+  if (!ok) {
+    Serial.printf("[SD] write %s failed\n", j.path);
+    portENTER_CRITICAL(&g_mux);
+    g_stats.dropped_bytes += j.len;
+    portEXIT_CRITICAL(&g_mux);
+  }
+  free(j.buf);
+}
+
+static void writer_run_jobs() {
+  for (;;) {
+    FileJob j;
+    portENTER_CRITICAL(&g_mux);
+    bool have = g_job_count > 0;
+    if (have) { j = g_jobs[0]; memmove(g_jobs, g_jobs + 1, --g_job_count * sizeof(FileJob)); }
+    portEXIT_CRITICAL(&g_mux);
+    if (!have) return;
+    writer_write_file(j);
+  }
+}
+
+static void writer_task(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SDLOG_CHECK_MS));
+    bool force = g_force_flush; g_force_flush = false;
+    portENTER_CRITICAL(&g_mux);
+    int n = g_ch_count;
+    portEXIT_CRITICAL(&g_mux);
+    for (int i = 0; i < n; i++) {
+#if SDLOG_FORMAT
+      writer_seal(g_ch[i], force);
+#endif
+      writer_flush_channel(g_ch[i], force);
+    }
+    writer_run_jobs();
+  }
+}
 
 bool sdlog_begin() {
 #if USE_SD_MMC
@@ -17,46 +196,169 @@ bool sdlog_begin() {
   g_sd_ok = SD.begin();
 #endif
   if (!g_sd_ok) Serial.println("[SD] init failed"); else Serial.println("[SD] init ok");
-  return g_sd_ok;
-}
+  if (!g_sd_ok) return false;
 
-static String file_for(const char* measurement) {
-  String p = "/"; p += measurement; p += ".csv"; return p;
+  // A channel is usable only with both buffers (and its encoder); a partial
+  // allocation is released and the channel count capped there.
+  for (g_ch_cap = 0; g_ch_cap < SDLOG_MAX_SERIES; g_ch_cap++) {
+    LogChannel& c = g_ch[g_ch_cap];
+    bool ok = true;
+    for (int b = 0; b < 2; b++) {
+      c.buf[b] = (char*)heap_caps_malloc(SDLOG_BUF_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (!c.buf[b]) c.buf[b] = (char*)malloc(SDLOG_BUF_BYTES);
+      ok &= c.buf[b] != nullptr;
+    }
+#if SDLOG_FORMAT
+    for (int b = 0; b < 2; b++) {
+      c.enc[b] = (TslEncoder*)heap_caps_malloc(sizeof(TslEncoder), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (!c.enc[b]) c.enc[b] = (TslEncoder*)malloc(sizeof(TslEncoder));
+      ok &= c.enc[b] != nullptr;
+    }
+#endif
+    if (!ok) {
+      free(c.buf[0]); free(c.buf[1]); c.buf[0] = c.buf[1] = nullptr;
+#if SDLOG_FORMAT
+      free(c.enc[0]); free(c.enc[1]); c.enc[0] = c.enc[1] = nullptr;
+#endif
+      Serial.printf("[SD] log buffer alloc failed; %d of %d series can log\n", g_ch_cap, SDLOG_MAX_SERIES);
+      break;
+    }
+  }
+  if (xTaskCreatePinnedToCore(writer_task, "sd_writer", SDLOG_TASK_STACK, nullptr,
+                              SDLOG_TASK_PRIO, &g_writer, SDLOG_TASK_CORE) != pdPASS) {
+    Serial.println("[SD] writer task failed");
+    g_sd_ok = false;
+  }
+  return g_sd_ok;
 }
 
 bool sdlog_open_series(const char* measurement) {
   if (!g_sd_ok) return false;
-#if USE_SD_MMC
-  File f = SD_MMC.open(file_for(measurement), FILE_APPEND);
-#else
-  File f = SD.open(file_for(measurement), FILE_APPEND);
-#endif
-  if (!f) return false;
-  if (f.size() == 0) f.println("ms,value");
-  f.close(); return true;
+  portENTER_CRITICAL(&g_mux);
+  LogChannel* c = channel_for(measurement, true);
+  portEXIT_CRITICAL(&g_mux);
+  return c != nullptr;
 }
 
-void sdlog_append_csv(const char* measurement, uint32_t ms, float value) {
+void sdlog_append(const char* measurement, uint32_t ms, float value) {
   if (!g_sd_ok) return;
-#if USE_SD_MMC
-  File f = SD_MMC.open(file_for(measurement), FILE_APPEND);
+#if SDLOG_FORMAT
+  value = tsl_quantize(value, SDLOG_TSL_MANTISSA_BITS);
+#else
+  char line[32];
+  int n = snprintf(line, sizeof(line), "%lu,%.3f\n", (unsigned long)ms, value);
+  if (n <= 0 || n >= (int)sizeof(line)) return;
+#endif
+
+  bool wake = false;
+  portENTER_CRITICAL(&g_mux);
+  LogChannel* c = channel_for(measurement, true);
+  if (!c) {
+#if !SDLOG_FORMAT
+    g_stats.dropped_bytes += n;
+#endif
+    wake = true;
+  } else {
+#if SDLOG_FORMAT
+    // Only the bit packing happens under the lock; finished blocks go to the
+    // writer. Handing over by count, not age, gives slow and fast series
+    // equally full blocks. If the writer still holds the previous block, the
+    // open one keeps growing until it is full.
+    bool added = tsl_enc_add(*c->enc[c->cur], ms, value);
+    if ((!added || c->enc[c->cur]->count >= SDLOG_TSL_BLOCK_SAMPLES) && !c->pending) {
+      c->pending = true;
+      c->cur ^= 1;
+      wake = true;
+    }
+    if (!added && !tsl_enc_add(*c->enc[c->cur], ms, value)) g_stats.dropped_bytes += 8;   // raw t + v
+    wake |= c->used >= SDLOG_FLUSH_BYTES;
 #else
-  File f = SD.open(file_for(measurement), FILE_APPEND);
+    wake = !channel_put(*c, line, n) || c->used >= SDLOG_FLUSH_BYTES;
 #endif
-  if (!f) return;
-  f.print(ms); f.print(','); f.println(value, 3);
+  }
+  portEXIT_CRITICAL(&g_mux);
+  if (wake && g_writer) xTaskNotifyGive(g_writer);
+}
+
+void sdlog_flush() {
+  g_force_flush = true;
+  if (g_writer) xTaskNotifyGive(g_writer);
+}
+
+bool sdlog_submit_file(const char* path, void* buf, size_t len) {
+  bool ok = false;
+  if (g_sd_ok && strlen(path) < sizeof(g_jobs[0].path)) {
+    portENTER_CRITICAL(&g_mux);
+    if (g_job_count < SDLOG_FILE_JOBS) {
+      FileJob& j = g_jobs[g_job_count++];
+      strlcpy(j.path, path, sizeof(j.path));
+      j.buf = buf; j.len = len;
+      ok = true;
+    }
+    portEXIT_CRITICAL(&g_mux);
+  }
+  if (!ok) { free(buf); return false; }
+  xTaskNotifyGive(g_writer);
+  return true;
+}
+
+size_t sdlog_read_file(const char* path, void* buf, size_t cap) {
+  if (!g_sd_ok) return 0;
+  File f = SD_FS.open(path, FILE_READ);
+  if (!f) {
+    char tmp[40];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    f = SD_FS.open(tmp, FILE_READ);
+    if (!f) return 0;
+  }
+  size_t n = f.size();
+  if (n > cap || f.read((uint8_t*)buf, n) != n) n = 0;
   f.close();
+  return n;
+}
+
+SdLogStats sdlog_get_stats() {
+  uint32_t backlog = 0;
+  portENTER_CRITICAL(&g_mux);
+  SdLogStats s = g_stats;
+  for (int i = 0; i < g_ch_count; i++) {
+    backlog += g_ch[i].used;
+#if SDLOG_FORMAT
+    backlog += (g_ch[i].enc[0]->bitpos + 7) / 8 + (g_ch[i].enc[1]->bitpos + 7) / 8;
+#endif
+  }
+  portEXIT_CRITICAL(&g_mux);
+  s.backlog_bytes = backlog;
+  return s;
+}
+
+static void* ps_calloc_or_internal(size_t n, size_t sz) {
+  void* p = heap_caps_calloc(n, sz, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  return p ? p : heap_caps_calloc(n, sz, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
 }
 
 void series_init(SeriesRuntime& s, const SeriesConfig& cfg) {
   s.cfg = cfg; s.head = 0; s.last_store = 0;
   s.values = (float*)heap_caps_calloc(cfg.points, sizeof(float), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  s.mins   = (float*)ps_calloc_or_internal(cfg.points, sizeof(float));
+  s.maxs   = (float*)ps_calloc_or_internal(cfg.points, sizeof(float));
+  s.counts = (uint16_t*)ps_calloc_or_internal(cfg.points, sizeof(uint16_t));
+}
+
+void series_store_bucket(SeriesRuntime& s, uint32_t now_ms, float mean, float min, float max, uint32_t count) {
+  s.last_store = now_ms;
+  if (!s.values) return;
+  uint32_t i = s.head;
+  s.values[i] = mean;
+  if (s.mins)   s.mins[i] = min;
+  if (s.maxs)   s.maxs[i] = max;
+  if (s.counts) s.counts[i] = (uint16_t)(count > 0xFFFF ? 0xFFFF : count);
+  s.head = (i + 1) % s.cfg.points;
 }
 
 bool series_maybe_store(SeriesRuntime& s, uint32_t now_ms, float value) {
   if (now_ms - s.last_store >= s.cfg.interval_ms) {
-    s.last_store = now_ms;
-    if (s.values) { s.values[s.head] = value; s.head = (s.head + 1) % s.cfg.points; }
+    series_store_bucket(s, now_ms, value, value, value, 1);
     return true;
   }
   return false;
@@ -1,9 +1,37 @@
 #pragma once
 #include <Arduino.h>
 struct SeriesConfig { const char* name; uint32_t points; uint32_t interval_ms; };
-struct SeriesRuntime { SeriesConfig cfg; float* values; uint32_t head; uint32_t last_store; };
+// Ring of per-bucket aggregates; values holds the bucket mean.
+struct SeriesRuntime {
+  SeriesConfig cfg;
+  float*    values;
+  float*    mins;
+  float*    maxs;
+  uint16_t* counts;
+  uint32_t  head;
+  uint32_t  last_store;
+};
+struct SdLogStats {
+  uint32_t flushes;
+  uint32_t flushed_bytes;
+  uint32_t last_flush_us;   // file write + flush time of the last batch
+  uint32_t max_flush_us;
+  uint32_t total_flush_us;
+  uint32_t backlog_bytes;   // buffered, not yet written
+  uint32_t dropped_bytes;   // buffer full, file could not be opened, or short write
+};
 bool sdlog_begin();
 bool sdlog_open_series(const char* measurement);
-void sdlog_append_csv(const char* measurement, uint32_t ms, float value);
+// Appends one sample in the SDLOG_FORMAT encoding (.csv or .tsl file).
+void sdlog_append(const char* measurement, uint32_t ms, float value);
+void sdlog_flush();
+// Hands a heap buffer to the writer task, which replaces `path` with it via a
+// temporary file and frees it. Returns false (and frees buf) if the queue is full.
+bool sdlog_submit_file(const char* path, void* buf, size_t len);
+// Synchronous whole-file read for boot-time restore. Returns bytes read, 0 on
+// error or if the file is larger than cap.
+size_t sdlog_read_file(const char* path, void* buf, size_t cap);
+SdLogStats sdlog_get_stats();
 void series_init(SeriesRuntime& s, const SeriesConfig& cfg);
 bool series_maybe_store(SeriesRuntime& s, uint32_t now_ms, float value);
+void series_store_bucket(SeriesRuntime& s, uint32_t now_ms, float mean, float min, float max, uint32_t count);
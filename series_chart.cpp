@@ -0,0 +1,355 @@
+#include "series_chart.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+struct SeriesChart {
+  const SeriesRuntime* s;
+  ChartColumn* cols;
+  int      ncols;
+  uint32_t seen_head, seen_store;
+  bool     dirty;
+  bool     has_data;
+  float    lo, hi;
+
+  // strip mode
+  bool         strip;
+  uint8_t*     px;          // A8, pw x ph
+  lv_img_dsc_t img;
+  float        s_lo, s_hi;  // y scale of the pixels in px
+  uint32_t     strip_head;  // ring head the pixels correspond to
+  uint32_t     strip_seq;   // running number of the newest bucket painted
+  uint32_t     lo_seq, hi_seq;   // buckets holding lo and hi
+  bool         strip_valid;
+  float        strip_join;  // mean of the column left of the rightmost one
+};
+
+int series_decimate(const SeriesRuntime& s, ChartColumn* cols, int ncols, float* lo, float* hi) {
+  for (int c = 0; c < ncols; c++) { cols[c].lo = FLT_MAX; cols[c].hi = -FLT_MAX; cols[c].last = NAN; }
+  *lo = FLT_MAX; *hi = -FLT_MAX;
+  if (!s.values || !s.cfg.points || ncols <= 0) return 0;
+
+  uint32_t n = s.cfg.points;
+  int used = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    uint32_t i = (s.head + k) % n;           // head is the oldest slot
+    if (s.counts && s.counts[i] == 0) continue;
+    float v = s.values[i];
+    if (isnan(v)) continue;
+    float mn = s.mins ? s.mins[i] : v, mx = s.maxs ? s.maxs[i] : v;
+    // A point covers columns [c0, c1); with fewer points than columns it spans several.
+    int c0 = (int)((uint64_t)k * ncols / n);
+    int c1 = (int)((uint64_t)(k + 1) * ncols / n);
+    if (c1 == c0) c1 = c0 + 1;
+    for (int c = c0; c < c1; c++) {
+      ChartColumn& col = cols[c];
+      if (col.lo > col.hi) used++;
+      if (mn < col.lo) col.lo = mn;
+      if (mx > col.hi) col.hi = mx;
+      col.last = v;
+    }
+    if (mn < *lo) *lo = mn;
+    if (mx > *hi) *hi = mx;
+  }
+  return used;
+}
+
+static void rebuild(lv_obj_t* obj, SeriesChart* ch) {
+  int w = lv_obj_get_content_width(obj);
+  if (w <= 0) return;
+  if (w != ch->ncols) {
+    free(ch->cols);
+    ch->cols = (ChartColumn*)heap_caps_malloc(w * sizeof(ChartColumn), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ch->cols) ch->cols = (ChartColumn*)malloc(w * sizeof(ChartColumn));
+    ch->ncols = ch->cols ? w : 0;
+  }
+  ch->has_data = false;
+  if (ch->s && ch->cols) {
+    ch->seen_head = ch->s->head;
+    ch->seen_store = ch->s->last_store;
+    ch->has_data = series_decimate(*ch->s, ch->cols, ch->ncols, &ch->lo, &ch->hi) > 0;
+  }
+  ch->dirty = false;
+}
+
+// ---- strip mode ----
+
+static bool strip_alloc(lv_obj_t* obj, SeriesChart* ch) {
+  int w = lv_obj_get_content_width(obj), h = lv_obj_get_content_height(obj);
+  if (w <= 0 || h <= 0) return false;
+  if (ch->px && ch->img.header.w == w && ch->img.header.h == h) return true;
+  free(ch->px);
+  ch->px = (uint8_t*)heap_caps_malloc((size_t)w * h, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!ch->px) return false;
+  memset(&ch->img, 0, sizeof(ch->img));
+  ch->img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+  ch->img.header.w = w;
+  ch->img.header.h = h;
+  ch->img.data_size = (uint32_t)w * h;
+  ch->img.data = ch->px;
+  ch->strip_valid = false;
+  return true;
+}
+
+// Columns are tied to the running bucket number q, not to ring slots: column
+// j covers q in [j*n/w, (j+1)*n/w), so w columns span the whole n-bucket ring
+// and the plot moves left by a column each time q crosses a column boundary.
+// Rightmost column, the one the newest bucket reaches:
+static uint64_t strip_right_col(const SeriesChart* ch, uint32_t seq) {
+  uint64_t w = ch->img.header.w, n = ch->s->cfg.points;
+  return (((uint64_t)seq + 1) * w - 1) / n;
+}
+
+// Min/max/last of the buckets in column j that are still in the ring.
+static bool strip_column(const SeriesChart* ch, uint32_t head, uint64_t j, float* mn, float* mx, float* last) {
+  const SeriesRuntime& s = *ch->s;
+  uint64_t w = ch->img.header.w, n = s.cfg.points, seq = ch->strip_seq;
+  uint64_t q0 = (j * n + w - 1) / w, q1 = ((j + 1) * n + w - 1) / w;
+  if (q1 <= q0) { q0 = j * n / w; q1 = q0 + 1; }   // wider than the ring: a bucket spans columns
+  if (q1 > seq + 1) q1 = seq + 1;
+  if (q0 + n <= seq) q0 = seq + 1 - n;
+  *mn = FLT_MAX; *mx = -FLT_MAX;
+  bool any = false;
+  for (uint64_t q = q0; q < q1; q++) {
+    uint32_t i = (uint32_t)((head + n - 1 - (seq - q)) % n);
+    if ((s.counts && s.counts[i] == 0) || isnan(s.values[i])) continue;
+    *mn = LV_MIN(*mn, s.mins ? s.mins[i] : s.values[i]);
+    *mx = LV_MAX(*mx, s.maxs ? s.maxs[i] : s.values[i]);
+    *last = s.values[i];
+    any = true;
+  }
+  return any;
+}
+
+static void strip_paint_col(SeriesChart* ch, int x, uint32_t head, uint64_t j, float* prev) {
+  int w = ch->img.header.w, h = ch->img.header.h;
+  for (int y = 0; y < h; y++) ch->px[y * w + x] = 0;
+  float mn, mx, last;
+  if (!strip_column(ch, head, j, &mn, &mx, &last)) { *prev = NAN; return; }
+  if (!isnan(*prev)) { mn = LV_MIN(mn, *prev); mx = LV_MAX(mx, *prev); }
+  *prev = last;
+  float scale = (h - 1) / (ch->s_hi - ch->s_lo);
+  int y1 = (h - 1) - (int)((mx - ch->s_lo) * scale);
+  int y2 = (h - 1) - (int)((mn - ch->s_lo) * scale);
+  y1 = LV_CLAMP(0, y1, h - 1);
+  y2 = LV_CLAMP(y1, y2, h - 1);
+  for (int y = y1; y <= y2; y++) ch->px[y * w + x] = 0xFF;
+}
+
+// Adds buckets [age_from, age_to] (newest is age 0) to lo/hi. Ties go to the
+// newer bucket so an extreme is dropped as late as possible.
+static void strip_add_range(SeriesChart* ch, uint32_t head, uint32_t age_from, uint32_t age_to) {
+  const SeriesRuntime& s = *ch->s;
+  uint32_t n = s.cfg.points;
+  for (uint32_t age = age_to + 1; age-- > age_from;) {
+    uint32_t i = (head + n - 1 - age) % n;
+    if ((s.counts && s.counts[i] == 0) || isnan(s.values[i])) continue;
+    float mn = s.mins ? s.mins[i] : s.values[i], mx = s.maxs ? s.maxs[i] : s.values[i];
+    if (mn <= ch->lo) { ch->lo = mn; ch->lo_seq = ch->strip_seq - age; }
+    if (mx >= ch->hi) { ch->hi = mx; ch->hi_seq = ch->strip_seq - age; }
+    ch->has_data = true;
+  }
+}
+
+static void strip_scan_range(SeriesChart* ch, uint32_t head) {
+  ch->lo = FLT_MAX; ch->hi = -FLT_MAX;
+  ch->has_data = false;
+  strip_add_range(ch, head, 0, ch->s->cfg.points - 1);
+}
+
+// 10% headroom so a slowly drifting signal does not force a repaint per bucket
+static float strip_pad(float lo, float hi) {
+  float pad = (hi - lo) * 0.10f;
+  return pad > 0 ? pad : fabsf(hi) * 0.01f + 0.01f;
+}
+
+// The pixels can be kept while the data fits the y scale and still fills most
+// of it; once the extremes have left the ring the scale shrinks to match.
+static bool strip_scale_ok(const SeriesChart* ch) {
+  if (!ch->has_data) return true;
+  if (ch->lo < ch->s_lo || ch->hi > ch->s_hi) return false;
+  return ch->s_hi - ch->s_lo <= 1.5f * (ch->hi - ch->lo + 2 * strip_pad(ch->lo, ch->hi));
+}
+
+// Paints columns [x0, w) from the ring, oldest first so each joins the one
+// before it; prev is the mean of column x0 - 1.
+static void strip_paint_cols(SeriesChart* ch, uint32_t head, int x0, float prev) {
+  int w = ch->img.header.w;
+  uint64_t j0 = strip_right_col(ch, ch->strip_seq) - (w - 1);
+  for (int x = x0; x < w; x++) {
+    if (x == w - 1) ch->strip_join = prev;
+    strip_paint_col(ch, x, head, j0 + x, &prev);
+  }
+}
+
+static void strip_repaint(SeriesChart* ch, uint32_t head) {
+  strip_scan_range(ch, head);
+  float lo = ch->has_data ? ch->lo : 0, hi = ch->has_data ? ch->hi : 1;
+  float pad = strip_pad(lo, hi);
+  ch->s_lo = lo - pad; ch->s_hi = hi + pad;
+  strip_paint_cols(ch, head, 0, NAN);
+  ch->strip_head = head;
+  ch->strip_valid = true;
+}
+
+// The plot lives in the chart's own A8 buffer ch->img between updates, so a
+// new bucket costs a memmove of that buffer one or more columns left plus the
+// rasterizing of the columns it touches; nothing else is recomputed. When
+// nothing shifted (several buckets per column) only the rightmost column is
+// invalidated. After a shift every column has moved and the whole chart is
+// invalidated, but LVGL redraws it from the widget tree as a single image
+// blit of ch->img rather than a re-decimation of the ring.
+static void strip_update(lv_obj_t* obj, SeriesChart* ch) {
+  if (!strip_alloc(obj, ch)) return;
+  const SeriesRuntime& s = *ch->s;
+  int w = ch->img.header.w, h = ch->img.header.h;
+  uint32_t head = s.head, n = s.cfg.points;
+  uint32_t k = (head + n - ch->strip_head) % n;
+  bool full = ch->dirty || !ch->strip_valid || k == 0;
+  uint64_t right = strip_right_col(ch, ch->strip_seq);
+  ch->strip_seq = ch->strip_valid ? ch->strip_seq + k : n;   // starts at n so q never goes negative
+  int shift = (int)(strip_right_col(ch, ch->strip_seq) - right);
+  if (!full && shift >= w / 4) full = true;
+  if (!full) {
+    // An extreme that was overwritten needs a rescan; otherwise add the new buckets
+    if (ch->strip_seq - ch->lo_seq >= n || ch->strip_seq - ch->hi_seq >= n) strip_scan_range(ch, head);
+    else strip_add_range(ch, head, 0, k - 1);
+    full = !strip_scale_ok(ch);
+  }
+
+  if (full) {
+    strip_repaint(ch, head);
+    lv_obj_invalidate(obj);
+  } else {
+    // A plain memmove per row: the PPA cannot blit a buffer onto itself, and a
+    // second buffer would cost another w*h of PSRAM for a copy done once per column.
+    if (shift > 0)
+      for (int y = 0; y < h; y++) memmove(ch->px + y * w, ch->px + y * w + shift, w - shift);
+    strip_paint_cols(ch, head, w - 1 - shift, ch->strip_join);
+    ch->strip_head = head;
+    if (shift > 0) {
+      lv_obj_invalidate(obj);
+    } else {
+      lv_area_t a;
+      lv_obj_get_content_coords(obj, &a);
+      a.x1 = a.x2;
+      lv_obj_invalidate_area(obj, &a);
+    }
+  }
+  lv_img_cache_invalidate_src(&ch->img);
+  ch->seen_head = head;
+  ch->seen_store = s.last_store;
+  ch->dirty = false;
+}
+
+static void chart_event_cb(lv_event_t* e) {
+  lv_obj_t* obj = lv_event_get_target(e);
+  SeriesChart* ch = (SeriesChart*)lv_obj_get_user_data(obj);
+  lv_event_code_t code = lv_event_get_code(e);
+
+  if (code == LV_EVENT_DELETE) {
+    free(ch->cols); free(ch->px); free(ch);
+    return;
+  }
+  if (code == LV_EVENT_SIZE_CHANGED) { ch->dirty = true; return; }
+  if (code != LV_EVENT_DRAW_MAIN) return;
+
+  if (ch->strip) {
+    if (!ch->s) return;
+    if (ch->dirty || !ch->strip_valid || ch->img.header.w != lv_obj_get_content_width(obj)) strip_update(obj, ch);
+    if (!ch->px || !ch->strip_valid) return;
+    lv_area_t area;
+    lv_obj_get_content_coords(obj, &area);
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    dsc.recolor = lv_obj_get_style_line_color(obj, LV_PART_MAIN);   // A8 images take their colour from recolor
+    dsc.recolor_opa = LV_OPA_COVER;
+    lv_draw_img(lv_event_get_draw_ctx(e), &dsc, &area, &ch->img);
+    return;
+  }
+
+  if (ch->dirty || ch->ncols != lv_obj_get_content_width(obj)) rebuild(obj, ch);
+  if (!ch->has_data) return;
+
+  lv_draw_ctx_t* draw_ctx = lv_event_get_draw_ctx(e);
+  lv_area_t area;
+  lv_obj_get_content_coords(obj, &area);
+  lv_coord_t h = lv_area_get_height(&area);
+
+  // 5% headroom; a flat line sits mid-height.
+  float lo = ch->lo, hi = ch->hi;
+  float pad = (hi - lo) * 0.05f;
+  if (pad <= 0) pad = fabsf(hi) * 0.01f + 0.01f;
+  lo -= pad; hi += pad;
+  float scale = (h - 1) / (hi - lo);
+
+  lv_draw_rect_dsc_t dsc;
+  lv_draw_rect_dsc_init(&dsc);
+  dsc.bg_color = lv_obj_get_style_line_color(obj, LV_PART_MAIN);
+  dsc.bg_opa = LV_OPA_COVER;
+
+  // Only the columns inside the clip area; stripe flushes redraw a band at a time.
+  int c_from = LV_MAX(0, draw_ctx->clip_area->x1 - area.x1);
+  int c_to   = LV_MIN(ch->ncols - 1, draw_ctx->clip_area->x2 - area.x1);
+  float prev = NAN;
+  if (c_from > 0) prev = ch->cols[c_from - 1].last;
+  for (int c = c_from; c <= c_to; c++) {
+    const ChartColumn& col = ch->cols[c];
+    if (col.lo > col.hi) { prev = NAN; continue; }
+    float mn = col.lo, mx = col.hi;
+    if (!isnan(prev)) { mn = LV_MIN(mn, prev); mx = LV_MAX(mx, prev); }   // join to the previous column
+    prev = col.last;
+    lv_area_t r;
+    r.x1 = r.x2 = area.x1 + c;
+    r.y1 = area.y2 - (lv_coord_t)((mx - lo) * scale);
+    r.y2 = area.y2 - (lv_coord_t)((mn - lo) * scale);
+    if (r.y2 - r.y1 < 1) r.y2 = r.y1 + 1;
+    lv_draw_rect(draw_ctx, &dsc, &r);
+  }
+}
+
+lv_obj_t* series_chart_create(lv_obj_t* parent) {
+  lv_obj_t* obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_style_line_color(obj, lv_color_hex(CLR_CYAN), 0);
+  SeriesChart* ch = (SeriesChart*)calloc(1, sizeof(SeriesChart));
+  ch->dirty = true;
+  lv_obj_set_user_data(obj, ch);
+  lv_obj_add_event_cb(obj, chart_event_cb, LV_EVENT_ALL, nullptr);
+  return obj;
+}
+
+void series_chart_set_strip(lv_obj_t* chart, bool enable) {
+  SeriesChart* ch = (SeriesChart*)lv_obj_get_user_data(chart);
+  ch->strip = enable;
+  ch->strip_valid = false;
+  ch->dirty = true;
+  lv_obj_invalidate(chart);
+}
+
+void series_chart_set_series(lv_obj_t* chart, const SeriesRuntime* s) {
+  SeriesChart* ch = (SeriesChart*)lv_obj_get_user_data(chart);
+  ch->s = s;
+  ch->dirty = true;
+  lv_obj_invalidate(chart);
+}
+
+bool series_chart_refresh(lv_obj_t* chart) {
+  SeriesChart* ch = (SeriesChart*)lv_obj_get_user_data(chart);
+  if (!ch->s) return false;
+  if (!ch->dirty && ch->s->head == ch->seen_head && ch->s->last_store == ch->seen_store) return false;
+  if (ch->strip) { strip_update(chart, ch); return true; }
+  rebuild(chart, ch);
+  lv_obj_invalidate(chart);
+  return true;
+}
+
+bool series_chart_get_range(lv_obj_t* chart, float* lo, float* hi) {
+  SeriesChart* ch = (SeriesChart*)lv_obj_get_user_data(chart);
+  if (!ch->has_data) return false;
+  *lo = ch->lo; *hi = ch->hi;
+  return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <lvgl.h>
+#include "sdlog.h"
+
+// Line chart for a SeriesRuntime ring. The ring is decimated to one min/max
+// span per pixel column whenever a new bucket lands, so drawing costs one
+// 1-px rect per column no matter how many points the ring holds. Buckets with
+// count 0 (e.g. the restore gap marker) leave a hole.
+struct ChartColumn { float lo, hi, last; };   // lo > hi: no data in this column
+
+// Strip mode keeps the plot in an A8 pixel buffer and scrolls it. The ring
+// is decimated to the chart width as in column mode, but the columns are tied
+// to the bucket count, so a new bucket either redraws the rightmost column or
+// shifts the buffer left (memmove) and rasterizes only the exposed columns.
+// A full repaint happens only on rescale: new data leaves the y scale, or the
+// extremes have left the ring and the data fills well under the scale.
+lv_obj_t* series_chart_create(lv_obj_t* parent);
+void series_chart_set_strip(lv_obj_t* chart, bool enable);
+void series_chart_set_series(lv_obj_t* chart, const SeriesRuntime* s);
+// Re-decimates if the ring advanced since the last call. Returns true when it did.
+bool series_chart_refresh(lv_obj_t* chart);
+// Y range of the visible data; false while the ring is empty.
+bool series_chart_get_range(lv_obj_t* chart, float* lo, float* hi);
+
+// Oldest-to-newest decimation of s into ncols columns; O(points + ncols).
+// Returns the number of columns that received data and their overall range.
+int series_decimate(const SeriesRuntime& s, ChartColumn* cols, int ncols, float* lo, float* hi);
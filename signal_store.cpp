@@ -0,0 +1,46 @@
+#include "signal_store.h"
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+struct SignalSlot {
+  std::atomic<uint32_t> seq;     // odd while a write is in progress
+  std::atomic<uint32_t> value;   // float bits
+  std::atomic<uint32_t> ms;
+};
+
+static SignalSlot g_sig[SIG_COUNT];
+
+// One writer per signal; concurrent writers to the same id are not supported.
+void signal_set(SignalId id, float value) {
+  if (id >= SIG_COUNT) return;
+  SignalSlot& s = g_sig[id];
+  uint32_t bits; memcpy(&bits, &value, 4);
+  uint32_t q = s.seq.load(std::memory_order_relaxed);
+  s.seq.store(q + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.value.store(bits, std::memory_order_relaxed);
+  s.ms.store(millis(), std::memory_order_relaxed);
+  s.seq.store(q + 2, std::memory_order_release);
+}
+
+bool signal_get(SignalId id, SignalSample* out) {
+  if (id >= SIG_COUNT) return false;
+  SignalSlot& s = g_sig[id];
+  uint32_t q, bits, ms;
+  do {
+    q = s.seq.load(std::memory_order_acquire);
+    bits = s.value.load(std::memory_order_relaxed);
+    ms = s.ms.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((q & 1) || q != s.seq.load(std::memory_order_relaxed));
+  if (q == 0) return false;
+  memcpy(&out->value, &bits, 4);
+  out->ms = ms;
+  out->seq = q;
+  return true;
+}
+
+uint32_t signal_seq(SignalId id) {
+  return id < SIG_COUNT ? g_sig[id].seq.load(std::memory_order_acquire) & ~1u : 0;
+}
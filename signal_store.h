@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+
+// Latest value of every decoded signal. Decoders write with signal_set() from
+// whatever task parses the bus; the UI reads once per frame from ui_tick().
+// Each slot is a seqlock, so a reader never sees a value paired with the
+// wrong timestamp, and seq lets it skip signals that did not change.
+enum SignalId : uint8_t {
+  SIG_RPM,
+  SIG_POWER_KW,
+  SIG_BATT_V,
+  SIG_WIND_SPEED,   // m/s
+  SIG_WIND_ANGLE,   // rad
+  SIG_GNSS_LAT,     // deg; written only while there is a fix
+  SIG_GNSS_LON,     // deg
+  SIG_GNSS_SATS,    // satellites in view
+  SIG_COUNT
+};
+
+struct SignalSample {
+  float    value;
+  uint32_t ms;    // millis() of the last write
+  uint32_t seq;   // even, bumps by 2 per write; 0 = never written
+};
+
+void signal_set(SignalId id, float value);
+// Returns false if the signal was never written.
+bool signal_get(SignalId id, SignalSample* out);
+uint32_t signal_seq(SignalId id);
@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Fixed-size, lock-free single-producer/single-consumer ring.
+// push() may only be called from one task and pop() from one other task.
+// N must be a power of two; indices run freely and wrap through the mask.
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  bool push(const T& v) {
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    uint32_t t = tail_.load(std::memory_order_acquire);
+    if (h - t >= N) {
+      overflows_.store(overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    buf_[h & (N - 1)] = v;
+    head_.store(h + 1, std::memory_order_release);
+    uint32_t depth = h + 1 - t;
+    if (depth > high_water_.load(std::memory_order_relaxed)) high_water_.store(depth, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool pop(T& out) {
+    uint32_t t = tail_.load(std::memory_order_relaxed);
+    uint32_t h = head_.load(std::memory_order_acquire);
+    if (t == h) return false;
+    out = buf_[t & (N - 1)];
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when read from a third task.
+  uint32_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  uint32_t overflows()  const { return overflows_.load(std::memory_order_relaxed); }
+  uint32_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+  static constexpr size_t capacity() { return N; }
+
+private:
+  // Producer and consumer indices live on separate cache lines.
+  alignas(64) std::atomic<uint32_t> head_{0};
+  alignas(64) std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> overflows_{0};   // producer-written
+  std::atomic<uint32_t> high_water_{0};  // producer-written
+  T buf_[N];
+};
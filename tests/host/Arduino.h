@@ -0,0 +1,68 @@
+#pragma once
+// Host stand-in for the parts of the Arduino core the tested modules use.
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+// Tests may drive time by hand; 0 returns to the wall clock.
+void host_set_millis(uint32_t ms);
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const char* s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+  size_t print(const char* s) { return write(s); }
+  size_t println(const char* s = "") { return write(s) + write((uint8_t)'\n'); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return write(buf);
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+};
+
+// Writes to stdout; never has input.
+class HostSerial : public Stream {
+public:
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+};
+extern HostSerial Serial;
+
+// Single-threaded stand-ins for the FreeRTOS calls the modules make; tests
+// drive the code directly, so task creation fails and notifications are no-ops.
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdFAIL  0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY 0xFFFFFFFFu
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, int, TaskHandle_t*, int) {
+  return pdFAIL;
+}
+
+class HardwareSerial : public HostSerial {
+public:
+  template <class F> void onReceive(F) {}
+};
@@ -0,0 +1,17 @@
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+
+static uint32_t s_fake_ms = 0;
+
+static uint64_t wall_us() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+uint32_t millis() { return s_fake_ms ? s_fake_ms : (uint32_t)(wall_us() / 1000); }
+uint32_t micros() { return (uint32_t)wall_us(); }
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void host_set_millis(uint32_t ms) { s_fake_ms = ms; }
@@ -0,0 +1,10 @@
+#pragma once
+// Host stand-in: every capability is plain malloc.
+#include <stdint.h>
+#include <stdlib.h>
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+static inline void* heap_caps_malloc(size_t n, uint32_t caps) { (void)caps; return malloc(n); }
+static inline void heap_caps_free(void* p) { free(p); }
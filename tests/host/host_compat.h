@@ -0,0 +1,11 @@
+#pragma once
+// Force-included into every host target.
+#include <string.h>
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+// newlib and glibc >= 2.38 have it
+static inline size_t strlcpy(char* dst, const char* src, size_t cap) {
+  size_t n = strlen(src);
+  if (cap) { size_t c = n < cap - 1 ? n : cap - 1; memcpy(dst, src, c); dst[c] = '\0'; }
+  return n;
+}
+#endif
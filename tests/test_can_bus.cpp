@@ -0,0 +1,198 @@
+// CAN bridge framing: SLCAN and binary decoding, protocol auto-detection and
+// re-detection, resync after corrupt or truncated binary frames, then decode
+// throughput of both encodings. can_bus.cpp is included to reach its parsers.
+#include "test_util.h"
+#include "Arduino.h"
+#include "../can_bus.cpp"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+struct FakeStream : Stream {
+  std::vector<uint8_t> d;
+  size_t i = 0;
+  size_t write(uint8_t) override { return 1; }
+  int available() override { return (int)(d.size() - i); }
+  int read() override { return i < d.size() ? d[i++] : -1; }
+};
+
+static void reset_bridge(FakeStream& fs) {
+  g_mode = CANBRIDGE_PROTOCOL;
+  g_detect_kind = CANBRIDGE_PROTO_AUTO;
+  g_detect_streak = 0;
+  g_rejects = 0;
+  g_crc_errors = 0;
+  g_frames = 0;
+  fs.d.clear();
+  fs.i = 0;
+  canbridge_begin(fs);
+}
+
+static CanFrame make_frame(uint32_t id, uint8_t len, uint8_t seed) {
+  CanFrame f;
+  f.id = id; f.len = len; f.valid = true;
+  for (int i = 0; i < len; i++) f.data[i] = (uint8_t)(seed + i * 17);
+  return f;
+}
+
+static void put_bin(std::vector<uint8_t>& d, const CanFrame& f) {
+  uint8_t b[16] = { CANBIN_SYNC, (uint8_t)(0x80 | f.len),
+                    (uint8_t)f.id, (uint8_t)(f.id >> 8), (uint8_t)(f.id >> 16), (uint8_t)(f.id >> 24) };
+  memcpy(b + 6, f.data, f.len);
+  uint16_t crc = crc16_ccitt(b + 1, 5 + f.len);
+  b[6 + f.len] = (uint8_t)crc;
+  b[7 + f.len] = (uint8_t)(crc >> 8);
+  d.insert(d.end(), b, b + 8 + f.len);
+}
+
+static void put_slcan(std::vector<uint8_t>& d, const CanFrame& f) {
+  char line[32];
+  int n = snprintf(line, sizeof(line), "T%08X%d", (unsigned)f.id, f.len);
+  for (int i = 0; i < f.len; i++) n += snprintf(line + n, sizeof(line) - n, "%02X", f.data[i]);
+  n += snprintf(line + n, sizeof(line) - n, "\r\n");
+  d.insert(d.end(), line, line + n);
+}
+
+static bool same(const CanFrame& a, const CanFrame& b) {
+  return a.id == b.id && a.len == b.len && !memcmp(a.data, b.data, a.len);
+}
+
+static std::vector<CanFrame> read_all() {
+  std::vector<CanFrame> out;
+  CanFrame f;
+  while (canbridge_read(f)) out.push_back(f);
+  return out;
+}
+
+static void check_frames(const std::vector<CanFrame>& got, const std::vector<CanFrame>& want, const char* what) {
+  CHECK_MSG(got.size() == want.size(), "%s: got %zu frames, want %zu", what, got.size(), want.size());
+  for (size_t i = 0; i < got.size() && i < want.size(); i++)
+    CHECK_MSG(same(got[i], want[i]), "%s: frame %zu differs", what, i);
+}
+
+static void test_decode_and_lock() {
+  FakeStream fs;
+  for (int proto = CANBRIDGE_PROTO_SLCAN; proto <= CANBRIDGE_PROTO_BINARY; proto++) {
+    reset_bridge(fs);
+    std::vector<CanFrame> want;
+    for (int i = 0; i < 20; i++) {
+      CanFrame f = make_frame(0x09F80100u + i, (uint8_t)(i % 9), (uint8_t)i);
+      want.push_back(f);
+      if (proto == CANBRIDGE_PROTO_SLCAN) put_slcan(fs.d, f); else put_bin(fs.d, f);
+    }
+    check_frames(read_all(), want, proto == CANBRIDGE_PROTO_SLCAN ? "slcan" : "binary");
+    CHECK_MSG(g_mode == proto, "proto=%d locked mode=%d", proto, g_mode);
+  }
+}
+
+// Locked to binary, the link switches to SLCAN: the hunted-over text counts
+// as rejects, detection re-arms and SLCAN locks again. And back.
+static void test_redetect() {
+  FakeStream fs;
+  reset_bridge(fs);
+  for (int i = 0; i < 5; i++) put_bin(fs.d, make_frame(0x100 + i, 8, (uint8_t)i));
+  read_all();
+  CHECK(g_mode == CANBRIDGE_PROTO_BINARY);
+
+  fs.d.clear(); fs.i = 0;
+  std::vector<CanFrame> want;
+  for (int i = 0; i < 40; i++) {
+    CanFrame f = make_frame(0x200 + i, 8, (uint8_t)i);
+    put_slcan(fs.d, f);
+    want.push_back(f);
+  }
+  std::vector<CanFrame> got = read_all();
+  CHECK_MSG(g_mode == CANBRIDGE_PROTO_SLCAN, "after SLCAN input mode=%d", g_mode);
+  // Lines consumed while still locked to binary are lost; the rest decode
+  CHECK_MSG(got.size() >= 30, "only %zu SLCAN frames after re-detection", got.size());
+  if (!got.empty()) CHECK(same(got.back(), want.back()));
+
+  fs.d.clear(); fs.i = 0;
+  for (int i = 0; i < 40; i++) put_bin(fs.d, make_frame(0x300 + i, 8, (uint8_t)i));
+  got = read_all();
+  CHECK_MSG(g_mode == CANBRIDGE_PROTO_BINARY, "after binary input mode=%d", g_mode);
+  CHECK_MSG(got.size() >= 20, "only %zu binary frames after re-detection", got.size());
+}
+
+// A frame cut short by a dropped UART byte swallows the sync of the next
+// one; the parser must find it again instead of losing both frames.
+static void test_resync() {
+  FakeStream fs;
+  reset_bridge(fs);
+  g_mode = CANBRIDGE_PROTO_BINARY;
+  std::vector<CanFrame> want;
+  for (int i = 0; i < 200; i++) {
+    CanFrame f = make_frame(0x0DF50B00u + i, (uint8_t)(i % 9), (uint8_t)(i * 3));
+    size_t at = fs.d.size();
+    put_bin(fs.d, f);
+    switch (i % 4) {
+      case 1: fs.d.erase(fs.d.begin() + at + 3 + (i % 4)); break;   // truncated
+      case 2: fs.d[at + 2] ^= 0x40; break;                          // bad CRC
+      case 3: fs.d.insert(fs.d.begin() + at, { 0x00, CANBIN_SYNC, 0x7F, 0x12 }); want.push_back(f); break;
+      default: want.push_back(f); break;
+    }
+  }
+  check_frames(read_all(), want, "resync");
+  CHECK(g_crc_errors > 0);
+  CHECK(g_mode == CANBRIDGE_PROTO_BINARY);
+}
+
+// Random noise between good frames, including stray sync bytes
+static void test_noise() {
+  FakeStream fs;
+  reset_bridge(fs);
+  g_mode = CANBRIDGE_PROTO_BINARY;
+  srand(7);
+  std::vector<CanFrame> want;
+  for (int i = 0; i < 500; i++) {
+    int junk = rand() % 6;
+    for (int k = 0; k < junk; k++) fs.d.push_back(rand() % 4 ? (uint8_t)rand() : CANBIN_SYNC);
+    CanFrame f = make_frame(0x18EEFF00u + i, 8, (uint8_t)i);
+    put_bin(fs.d, f);
+    want.push_back(f);
+  }
+  std::vector<CanFrame> got = read_all();
+  // Junk can occasionally pass as a frame header and eat a real frame; nearly
+  // all must survive and every one that does must be genuine.
+  CHECK_MSG(got.size() >= want.size() * 97 / 100, "noise: %zu of %zu frames", got.size(), want.size());
+  size_t j = 0;
+  for (const CanFrame& f : got) {
+    while (j < want.size() && !same(f, want[j])) j++;
+    CHECK_MSG(j < want.size(), "noise: decoded a frame that was never sent (id %08X)", (unsigned)f.id);
+  }
+}
+
+static void bench(int proto) {
+  FakeStream fs;
+  std::vector<uint8_t> stream;
+  const int N = 20000;
+  for (int i = 0; i < N; i++) {
+    CanFrame f = make_frame(0x09F80100u + (i & 63), 8, (uint8_t)i);
+    if (proto == CANBRIDGE_PROTO_SLCAN) put_slcan(stream, f); else put_bin(stream, f);
+  }
+  uint32_t n = 0;
+  double ns = bench_ns([&] {
+    reset_bridge(fs);
+    g_mode = (uint8_t)proto;
+    CanFrame f;
+    n = 0;
+    for (uint8_t c : stream) n += bridge_feed(c, f);
+    keep(f);
+  }, N);
+  CHECK(n == (uint32_t)N);
+  double bytes = (double)stream.size() / N;
+  // Decode cost next to the UART time the same frame takes at CANBRIDGE_BAUD (8N1)
+  printf("%-6s %2.0f B/frame  %6.1f ns/frame  %5.2f ns/byte  wire %6.1f us/frame\n",
+         proto == CANBRIDGE_PROTO_SLCAN ? "slcan" : "binary", bytes, ns, ns / bytes, bytes * 10e6 / CANBRIDGE_BAUD);
+}
+
+int main() {
+  CHECK(crc16_ccitt((const uint8_t*)"123456789", 9) == 0x29B1);   // CRC-16/CCITT-FALSE check value
+  test_decode_and_lock();
+  test_redetect();
+  test_resync();
+  test_noise();
+  bench(CANBRIDGE_PROTO_SLCAN);
+  bench(CANBRIDGE_PROTO_BINARY);
+  return test_result();
+}
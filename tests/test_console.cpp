@@ -0,0 +1,149 @@
+// Serial console parser on a fake Stream: lines split across polls, CR/LF
+// and CRLF endings, whitespace and argument limits, backspace, over-long
+// lines, help and unknown commands, and console_onoff.
+#include "test_util.h"
+#include "config.h"
+#include "console.h"
+#include <string>
+#include <vector>
+
+struct FakeStream : Stream {
+  std::string in, out;
+  size_t i = 0;
+  size_t write(uint8_t c) override { out += (char)c; return 1; }
+  int available() override { return (int)(in.size() - i); }
+  int read() override { return i < in.size() ? (uint8_t)in[i++] : -1; }
+};
+
+static std::vector<std::vector<std::string>> g_calls;
+
+static void cmd_rec(Print& out, int argc, char** argv) {
+  g_calls.emplace_back(argv, argv + argc);
+  out.println("[test] ok");
+}
+
+static const ConsoleCmd kCmds[] = {
+  { "rec",  "[args]", cmd_rec },
+  { "rec2", "",       cmd_rec },
+};
+
+static FakeStream g_io;
+
+static void feed(const std::string& s) {
+  g_io.in += s;
+  console_poll();
+}
+
+static void reset() {
+  g_io.in.clear(); g_io.out.clear(); g_io.i = 0;
+  g_calls.clear();
+  console_begin(g_io, kCmds, sizeof(kCmds) / sizeof(kCmds[0]));
+}
+
+static bool called_with(size_t k, std::vector<std::string> want) {
+  return k < g_calls.size() && g_calls[k] == want;
+}
+
+static void test_dispatch() {
+  reset();
+  feed("rec a bb ccc\n");
+  CHECK(g_calls.size() == 1 && called_with(0, { "rec", "a", "bb", "ccc" }));
+  CHECK(g_io.out == "[test] ok\n");
+
+  // Name match is exact: "rec2" is not "rec"
+  feed("rec2\r");
+  CHECK(called_with(1, { "rec2" }));
+
+  // CRLF runs once; blank and whitespace-only lines run nothing
+  feed("rec x\r\n\r\n   \t \n");
+  CHECK(g_calls.size() == 3 && called_with(2, { "rec", "x" }));
+
+  feed("  rec \t one\t\ttwo  \n");
+  CHECK(called_with(3, { "rec", "one", "two" }));
+}
+
+static void test_split_input() {
+  reset();
+  feed("re");
+  feed("c 1");
+  CHECK(g_calls.empty());
+  feed(" 2\nrec");
+  CHECK(g_calls.size() == 1 && called_with(0, { "rec", "1", "2" }));
+  feed(" 3\n");
+  CHECK(g_calls.size() == 2 && called_with(1, { "rec", "3" }));
+
+  // Byte at a time
+  for (char c : std::string("rec slow\n")) feed(std::string(1, c));
+  CHECK(called_with(2, { "rec", "slow" }));
+}
+
+static void test_backspace() {
+  reset();
+  feed("rex\bc a\x7F" "b\n");
+  CHECK(called_with(0, { "rec", "b" }));
+  // Backspace on an empty line is harmless
+  feed("\b\b\x7Frec\n");
+  CHECK(called_with(1, { "rec" }));
+}
+
+static void test_arg_limit() {
+  reset();
+  feed("rec 1 2 3 4 5 6 7 8\n");
+  CHECK_MSG(g_calls.size() == 1 && g_calls[0].size() == 6, "argc %zu", g_calls.empty() ? 0 : g_calls[0].size());
+}
+
+static void test_long_lines() {
+  reset();
+  // The longest line that fits runs
+  std::string arg(CONSOLE_LINE_MAX - 1 - 4, 'x');
+  feed("rec " + arg + "\n");
+  CHECK(called_with(0, { "rec", arg }));
+
+  // One byte more is dropped whole, with a message, and the next line is clean
+  g_io.out.clear();
+  feed("rec " + arg + "y\n");
+  CHECK(g_calls.size() == 1);
+  CHECK(g_io.out.find("[con] line too long, ignored") != std::string::npos);
+  feed("rec after\n");
+  CHECK(called_with(1, { "rec", "after" }));
+
+  // A long run of junk without a newline never overruns the buffer
+  reset();
+  feed(std::string(10 * CONSOLE_LINE_MAX, 'z'));
+  feed("\nrec ok\n");
+  CHECK(g_calls.size() == 1 && called_with(0, { "rec", "ok" }));
+}
+
+static void test_help_and_unknown() {
+  reset();
+  feed("help\n");
+  CHECK(g_calls.empty());
+  CHECK(g_io.out.find("[con]   rec [args]") != std::string::npos);
+  CHECK(g_io.out.find("[con]   rec2") != std::string::npos);
+  g_io.out.clear();
+  feed("?\n");
+  CHECK(g_io.out.find("[con] commands:") != std::string::npos);
+
+  g_io.out.clear();
+  feed("nope 1\n");
+  CHECK(g_calls.empty());
+  CHECK(g_io.out == "[con] unknown command 'nope' (try help)\n");
+}
+
+static void test_onoff() {
+  CHECK(console_onoff("on") == 1 && console_onoff("1") == 1);
+  CHECK(console_onoff("off") == 0 && console_onoff("0") == 0);
+  CHECK(console_onoff(nullptr) == -1 && console_onoff("") == -1);
+  CHECK(console_onoff("ON") == -1 && console_onoff("yes") == -1 && console_onoff("10") == -1);
+}
+
+int main() {
+  test_dispatch();
+  test_split_input();
+  test_backspace();
+  test_arg_limit();
+  test_long_lines();
+  test_help_and_unknown();
+  test_onoff();
+  return test_result();
+}
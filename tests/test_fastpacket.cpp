@@ -0,0 +1,252 @@
+// n2k_fastpacket reassembly driven by recorded bus traces: interleaved
+// senders, out-of-order and missing frames, sequence-counter rollover and
+// timeouts, then slot exhaustion. Trace lines are "<ms> <CAN id>#<data>",
+// candump-style; each trace lists the messages it must yield, in order.
+#include "test_util.h"
+#include "can_bus.h"
+#include "n2k_fastpacket.h"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+struct Expect { uint8_t src; uint32_t pgn; const char* hex; };
+
+static const char* const kInterleaved[] = {
+  "1000 0DF80505#202B7942BDF22106",
+  "1001 0DF80507#202B76AC0E8F53A7",
+  "1002 0DF0140A#8086A0B846C1C0EB",
+  "1003 0DF80505#21F0847762F0F3CB",
+  "1004 0DF80507#21356C88913F20F6",
+  "1005 0DF0140A#81C5348ADC799ADF",
+  "1006 0DF80505#224D764DC7072051",
+  "1007 0DF80507#22F72DB022D24D0A",
+  "1008 0DF0140A#82849BAD05D4A10A",
+  "1009 0DF80505#23159A0F89F2C6DA",
+  "1010 0DF80507#2396DAD43C1617C1",
+  "1011 0DF0140A#83C0441EAAEEB4B4",
+  "1012 0DF80505#24CAE344BB311245",
+  "1013 0DF80507#24A98E78129E0327",
+  "1014 0DF0140A#848EFA0B1F0ABD80",
+  "1015 0DF80505#25FD6F84DF9AD7C5",
+  "1016 0DF80507#25371065D095864F",
+  "1017 0DF0140A#85E998A35ABA5EA0",
+  "1018 0DF80505#26B3D0FFFFFFFFFF",
+  "1019 0DF80507#2615ADFFFFFFFFFF",
+  "1020 0DF0140A#86BD8799C1350D43",
+  "1021 0DF0140A#879E71897AA75FDE",
+  "1022 0DF0140A#883134A4AA72E056",
+  "1023 0DF0140A#8928AC6FE68A733D",
+  "1024 0DF0140A#8A1161A15D8EAE2B",
+  "1025 0DF0140A#8BB042D7958AEDB1",
+  "1026 0DF0140A#8CD594D6D112D34F",
+  "1027 0DF0140A#8D6602F4DE7110E9",
+  "1028 0DF0140A#8E93AE7422923D7D",
+  "1029 0DF0140A#8F171165DC1906F6",
+  "1030 0DF0140A#903D57997A0AD31B",
+  "1031 0DF0140A#913AAE4081F41FB4",
+  "1032 0DF0140A#9271653E3D577A8C",
+  "1033 0DF0140A#934103FFFFFFFFFF",
+};
+static const Expect kInterleavedExpect[] = {
+  { 5, 129029,
+    "7942BDF22106F0847762F0F3CB4D764DC7072051159A0F89F2C6DACAE344BB311245FD6F84DF9AD7"
+    "C5B3D0" },
+  { 7, 129029,
+    "76AC0E8F53A7356C88913F20F6F72DB022D24D0A96DAD43C1617C1A98E78129E0327371065D09586"
+    "4F15AD" },
+  { 10, 126996,
+    "A0B846C1C0EBC5348ADC799ADF849BAD05D4A10AC0441EAAEEB4B48EFA0B1F0ABD80E998A35ABA5E"
+    "A0BD8799C1350D439E71897AA75FDE3134A4AA72E05628AC6FE68A733D1161A15D8EAE2BB042D795"
+    "8AEDB1D594D6D112D34F6602F4DE7110E993AE7422923D7D171165DC1906F63D57997A0AD31B3AAE"
+    "4081F41FB471653E3D577A8C4103" },
+};
+
+static const char* const kOutOfOrder[] = {
+  "2000 0DF80505#402BF9CC198A7F89",
+  "2002 0DF80505#42173F1923F7102C",
+  "2004 0DF80505#41D81AF2A5001C40",
+  "2006 0DF80505#43FAA150A124B3C5",
+  "2008 0DF80505#44C79BB88761A8DB",
+  "2010 0DF80505#453F4101C2285B15",
+  "2012 0DF80505#46BFEBFFFFFFFFFF",
+  "2014 0DF80505#602BC216DC1BBEFE",
+  "2016 0DF80505#61A1D7D6EB097D6F",
+  "2018 0DF80505#628A24D972DA420E",
+  "2020 0DF80505#63A6BF863EED3FC0",
+  "2022 0DF80505#6437A33402F24978",
+  "2024 0DF80505#65C7162F32C05B0C",
+  "2026 0DF80505#66AE3EFFFFFFFFFF",
+};
+static const Expect kOutOfOrderExpect[] = {
+  { 5, 129029,
+    "C216DC1BBEFEA1D7D6EB097D6F8A24D972DA420EA6BF863EED3FC037A33402F24978C7162F32C05B"
+    "0CAE3E" },
+};
+
+static const char* const kMissing[] = {
+  "3000 0DF80505#802B0D3AF691992D",
+  "3002 0DF80505#81127A36331FA65C",
+  "3004 0DF80505#82277B5C7FE8C981",
+  "3006 0DF80505#84D352D4F74FCD4C",
+  "3008 0DF80505#855331FEF7E25F45",
+  "3010 0DF80505#868865FFFFFFFFFF",
+  "3012 0DF80505#A02B4BA17697D388",
+  "3014 0DF80505#A16F9D0B89F5C366",
+  "3016 0DF80505#A258B87AA4F749D6",
+  "3018 0DF80505#A3F569EF0EF625CC",
+  "3020 0DF80505#A417EF7578236F82",
+  "3022 0DF80505#A57B6184465F1282",
+  "3024 0DF80505#A65617FFFFFFFFFF",
+};
+static const Expect kMissingExpect[] = {
+  { 5, 129029,
+    "4BA17697D3886F9D0B89F5C36658B87AA4F749D6F569EF0EF625CC17EF7578236F827B6184465F12"
+    "825617" },
+};
+
+static const char* const kRollover[] = {
+  "4000 0DFA040C#C014A05DD82E2B3C",
+  "4003 0DFA040C#C12F879512B6E7AC",
+  "4006 0DFA040C#C2030FABA9DFC2F8",
+  "4009 0DFA040C#E014276BFAC840A3",
+  "4012 0DFA040C#E13D8C27DD39E080",
+  "4015 0DFA040C#E231BFBCE6978736",
+  "4018 0DFA040C#0014AD3AFCB41E96",
+  "4021 0DFA040C#015D4C5BBDE83F37",
+  "4024 0DFA040C#0248A9D7995FEAF6",
+  "4027 0DFA040C#20149F5A23365CC8",
+  "4030 0DFA040C#21B733888AC41B45",
+  "4033 0DFA040C#2215F58A7EB5AACE",
+  "4036 0DFA040C#E014E523B4FE394D",
+  "4039 0DFA040C#E18A3339395E60D5",
+  "4042 0DFA040C#00146780BD960FE3",
+  "4045 0DFA040C#01D0C4A19EFE99F7",
+  "4048 0DFA040C#020F61013777FB58",
+};
+static const Expect kRolloverExpect[] = {
+  { 12, 129540, "A05DD82E2B3C2F879512B6E7AC030FABA9DFC2F8" },
+  { 12, 129540, "276BFAC840A33D8C27DD39E08031BFBCE6978736" },
+  { 12, 129540, "AD3AFCB41E965D4C5BBDE83F3748A9D7995FEAF6" },
+  { 12, 129540, "9F5A23365CC8B733888AC41B4515F58A7EB5AACE" },
+  { 12, 129540, "6780BD960FE3D0C4A19EFE99F70F61013777FB58" },
+};
+
+static const char* const kTimeout[] = {
+  "10000 0DF80505#2014EB65636C12E3",
+  "10800 0DF80505#2139914E45EF2D19",
+  "10805 0DF80505#220DB87727FF09AD",
+  "10810 0DF80505#4014A5A8B0442911",
+  "11510 0DF80505#4128AF692066DF71",
+  "12210 0DF80505#42F8A13715D12766",
+};
+static const Expect kTimeoutExpect[] = {
+  { 5, 129029, "A5A8B044291128AF692066DF71F8A13715D12766" },
+};
+struct Replay {
+  const char* name;
+  const char* const* lines;
+  size_t nlines;
+  const Expect* expect;
+  size_t nexpect;
+};
+#define REPLAY(name, lines, expect) { name, lines, sizeof(lines) / sizeof(lines[0]), expect, sizeof(expect) / sizeof(expect[0]) }
+
+static const Replay kReplays[] = {
+  REPLAY("interleaved", kInterleaved, kInterleavedExpect),
+  REPLAY("out_of_order", kOutOfOrder, kOutOfOrderExpect),
+  REPLAY("missing", kMissing, kMissingExpect),
+  REPLAY("rollover", kRollover, kRolloverExpect),
+  REPLAY("timeout", kTimeout, kTimeoutExpect),
+};
+
+static std::vector<uint8_t> unhex(const char* s) {
+  std::vector<uint8_t> out;
+  for (; s[0] && s[1]; s += 2) {
+    char b[3] = { s[0], s[1], 0 };
+    out.push_back((uint8_t)strtoul(b, nullptr, 16));
+  }
+  return out;
+}
+
+struct Got { uint8_t src; uint32_t pgn; std::vector<uint8_t> data; };
+
+static std::vector<Got> replay(N2kFastPacket& fp, const Replay& r) {
+  std::vector<Got> got;
+  for (size_t i = 0; i < r.nlines; i++) {
+    char* p;
+    uint32_t ms = strtoul(r.lines[i], &p, 10);
+    uint32_t id = strtoul(p, &p, 16);
+    std::vector<uint8_t> d = unhex(p + 1);   // skip '#'
+    N2kMessage m;
+    if (n2k_fp_feed(fp, n2k_pgn(id), n2k_src(id), d.data(), (uint8_t)d.size(), ms, m))
+      got.push_back({ m.src, m.pgn, std::vector<uint8_t>(m.data, m.data + m.len) });
+  }
+  return got;
+}
+
+static void run_replay(const Replay& r) {
+  static N2kFastPacket fp;
+  n2k_fp_init(fp);
+  std::vector<Got> got = replay(fp, r);
+  CHECK_MSG(got.size() == r.nexpect, "%s: %zu messages, want %zu", r.name, got.size(), r.nexpect);
+  for (size_t i = 0; i < got.size() && i < r.nexpect; i++) {
+    const Expect& e = r.expect[i];
+    CHECK_MSG(got[i].src == e.src && got[i].pgn == e.pgn, "%s: message %zu from %u/%u, want %u/%u", r.name, i,
+              got[i].src, got[i].pgn, e.src, e.pgn);
+    CHECK_MSG(got[i].data == unhex(e.hex), "%s: message %zu payload differs", r.name, i);
+  }
+  CHECK_MSG(fp.stats.completed == r.nexpect, "%s: completed=%u", r.name, fp.stats.completed);
+}
+
+// What each damaged trace must cost, not just what it must deliver
+static void check_stats() {
+  static N2kFastPacket fp;
+  n2k_fp_init(fp);
+  replay(fp, kReplays[1]);   // out_of_order: frame 2 kills the session, 1 and 3..6 are orphans
+  CHECK_MSG(fp.stats.dropped == 6 && fp.stats.incomplete == 1, "out_of_order: dropped=%u incomplete=%u",
+            fp.stats.dropped, fp.stats.incomplete);
+  n2k_fp_init(fp);
+  replay(fp, kReplays[2]);   // missing: frame 4 breaks the run, 5 and 6 are orphans
+  CHECK_MSG(fp.stats.dropped == 3 && fp.stats.incomplete == 1, "missing: dropped=%u incomplete=%u",
+            fp.stats.dropped, fp.stats.incomplete);
+  n2k_fp_init(fp);
+  replay(fp, kReplays[3]);   // rollover: the unfinished seq 7 is superseded by seq 0
+  CHECK_MSG(fp.stats.dropped == 0 && fp.stats.incomplete == 1, "rollover: dropped=%u incomplete=%u",
+            fp.stats.dropped, fp.stats.incomplete);
+  n2k_fp_init(fp);
+  replay(fp, kReplays[4]);   // timeout: frame 1 arrives 800 ms late, frame 2 is then an orphan
+  CHECK_MSG(fp.stats.dropped == 2 && fp.stats.incomplete == 1, "timeout: dropped=%u incomplete=%u",
+            fp.stats.dropped, fp.stats.incomplete);
+}
+
+// More concurrent senders than slots: the oldest session is evicted, a stale
+// one is reused without counting as an eviction, the rest still complete.
+static void check_slots() {
+  static N2kFastPacket fp;
+  n2k_fp_init(fp);
+  N2kMessage m;
+  const uint32_t pgn = 129029;
+  uint8_t f0[8] = { 0x00, 13, 1, 2, 3, 4, 5, 6 };   // 13 bytes: frame 0 + one 7-byte frame
+  uint8_t f1[8] = { 0x01, 7, 8, 9, 10, 11, 12, 13 };
+  for (uint8_t src = 0; src <= N2K_FP_SLOTS; src++) n2k_fp_feed(fp, pgn, src, f0, 8, 100 + src, m);
+  CHECK_MSG(fp.stats.evicted == 1, "evicted=%u", fp.stats.evicted);
+  CHECK(!n2k_fp_feed(fp, pgn, 0, f1, 8, 120, m));   // src 0 was the oldest
+  int done = 0;
+  for (uint8_t src = 1; src <= N2K_FP_SLOTS; src++) done += n2k_fp_feed(fp, pgn, src, f1, 8, 120, m);
+  CHECK_MSG(done == N2K_FP_SLOTS, "completed %d of %d after eviction", done, N2K_FP_SLOTS);
+  CHECK(m.len == 13 && m.data[12] == 13);
+
+  n2k_fp_init(fp);
+  for (uint8_t src = 0; src < N2K_FP_SLOTS; src++) n2k_fp_feed(fp, pgn, src, f0, 8, 100, m);
+  n2k_fp_feed(fp, pgn, 50, f0, 8, 100 + N2K_FP_TIMEOUT_MS + 1, m);
+  CHECK_MSG(fp.stats.evicted == 0 && fp.stats.incomplete == 1, "stale reuse: evicted=%u incomplete=%u",
+            fp.stats.evicted, fp.stats.incomplete);
+  CHECK(n2k_fp_feed(fp, pgn, 50, f1, 8, 100 + N2K_FP_TIMEOUT_MS + 2, m) && m.src == 50);
+}
+
+int main() {
+  for (const Replay& r : kReplays) run_replay(r);
+  check_stats();
+  check_slots();
+  return test_result();
+}
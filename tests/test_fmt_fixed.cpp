@@ -0,0 +1,90 @@
+// fmt_fixed against snprintf: every rounding boundary and printed value for
+// |v| * 10^decimals up to 2e5 (the float nearest each one and its two
+// neighbours), the "--" cut-off, specials, then both timed on label values.
+#include "test_util.h"
+#include "fmt_fixed.h"
+#include <initializer_list>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const kFmt[3] = { "%.0f", "%.1f", "%.2f" };
+
+// snprintf, minus the sign of a value that rounds to zero ("-0.0")
+static void ref(char* out, float v, int d) {
+  snprintf(out, 32, kFmt[d], v);
+  if (out[0] != '-') return;
+  for (const char* p = out + 1; *p; p++)
+    if (*p >= '1' && *p <= '9') return;
+  memmove(out, out + 1, strlen(out));
+}
+
+static void check_boundaries(int d) {
+  const double scale = pow(10, d);
+  long checked = 0, ties = 0;
+  for (long n = -200000; n <= 200000; n++) {
+    for (double c : { n / scale, (n + 0.5) / scale }) {
+      float f = (float)c;
+      for (float v : { nextafterf(f, -INFINITY), f, nextafterf(f, INFINITY) }) {
+        char got[32], want[32];
+        int len = fmt_fixed(got, v, (uint8_t)d);
+        ref(want, v, d);
+        checked++;
+        CHECK(len == (int)strlen(got));
+        if (!strcmp(got, want)) continue;
+        // Allowed only where v is a tie to within float precision: fmt_fixed
+        // rounds half away from zero in float, snprintf exactly and half-even
+        double x = fabs((double)v) * scale;
+        if (fabs(x - floor(x) - 0.5) <= x * 1.2e-7 + 1e-9) { ties++; continue; }
+        CHECK_MSG(false, "%.9g with %d decimals: \"%s\", snprintf \"%s\"", v, d, got, want);
+      }
+    }
+  }
+  printf("%d decimals: %ld values, %ld differ only at float-precision ties\n", d, checked, ties);
+}
+
+static const char* fx(float v, int d) {
+  static char out[32];
+  fmt_fixed(out, v, (uint8_t)d);
+  return out;
+}
+
+static void check_limits() {
+  char out[32];
+  const float kLimit[3] = { 4e9f, 4e8f, 4e7f };
+  for (int d = 0; d < 3; d++) {
+    float below = nextafterf(kLimit[d], 0);
+    for (float s : { 1.0f, -1.0f }) {
+      CHECK_MSG(!strcmp(fx(s * kLimit[d], d), "--"), "d=%d at the limit", d);
+      const char* t = fx(s * below * 0.999f, d);
+      CHECK_MSG(strcmp(t, "--") && strlen(t) <= 15, "d=%d just below the limit: \"%s\"", d, t);
+    }
+  }
+  CHECK(!strcmp(fx(NAN, 1), "--"));
+  CHECK(!strcmp(fx(INFINITY, 0), "--"));
+  CHECK(!strcmp(fx(-INFINITY, 2), "--"));
+  CHECK(!strcmp(fx(-0.0f, 1), "0.0"));
+  CHECK(!strcmp(fx(-0.004f, 2), "0.00"));
+  CHECK(!strcmp(fx(1.5f, 7), "1.50"));   // decimals clamp to 2
+
+  const uint32_t kU[] = { 0, 7, 10, 65535, 4294967295u };
+  for (uint32_t u : kU) {
+    char want[16];
+    snprintf(want, sizeof(want), "%lu", (unsigned long)u);
+    CHECK(fmt_uint(out, u) == (int)strlen(want) && !strcmp(out, want));
+  }
+}
+
+int main() {
+  for (int d = 0; d < 3; d++) check_boundaries(d);
+  check_limits();
+
+  // Label-like values: battery volts, wind, kW
+  static float vals[1024];
+  for (int i = 0; i < 1024; i++) vals[i] = 12.0f + i * 0.0137f;
+  char buf[32];
+  double t_snp = bench_ns([&] { for (float v : vals) { snprintf(buf, sizeof(buf), "%.1f", v); keep(buf); } }, 1024);
+  double t_fix = bench_ns([&] { for (float v : vals) { fmt_fixed(buf, v, 1); keep(buf); } }, 1024);
+  printf("format %%.1f: snprintf %.1f ns  fmt_fixed %.1f ns  (%.1fx)\n", t_snp, t_fix, t_snp / t_fix);
+  return test_result();
+}
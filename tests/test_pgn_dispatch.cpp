@@ -0,0 +1,65 @@
+// PgnDispatch with a 54-route table (the firmware's routes plus common NMEA
+// 2000 PGNs): every route resolves to its own index, every other PGN in the
+// 18-bit space misses. Then lookups over a bus-like mix, hash vs linear scan.
+#include "test_util.h"
+#include "pgn_dispatch.h"
+#include <stdlib.h>
+#include <vector>
+
+static uint32_t g_decoded[64];
+template <int I>
+static void dec(uint8_t, const uint8_t*, uint16_t) { g_decoded[I]++; }
+
+#define R(i, pgn) { pgn, 1, false, dec<i> }
+static constexpr PgnRoute kRoutes[] = {
+  R(0, 127508),  R(1, 130306),  R(2, 129029),  R(3, 129540),  R(4, 126996),  R(5, 127488),  R(6, 127489),
+  R(7, 128267),  R(8, 128259),  R(9, 130310),  R(10, 130311), R(11, 130312), R(12, 127250), R(13, 127251),
+  R(14, 127257), R(15, 129025), R(16, 129026), R(17, 129283), R(18, 129284), R(19, 129285), R(20, 127505),
+  R(21, 127506), R(22, 127245), R(23, 127237), R(24, 126992), R(25, 60928),  R(26, 59904),  R(27, 126208),
+  R(28, 126464), R(29, 127493), R(30, 127497), R(31, 127501), R(32, 127502), R(33, 127513), R(34, 128000),
+  R(35, 128275), R(36, 129038), R(37, 129039), R(38, 129040), R(39, 129041), R(40, 129044), R(41, 129291),
+  R(42, 129539), R(43, 129794), R(44, 129809), R(45, 129810), R(46, 130074), R(47, 130316), R(48, 130577),
+  R(49, 130578), R(50, 127258), R(51, 130313), R(52, 130314), R(53, 126993),
+};
+#undef R
+static constexpr size_t kN = sizeof(kRoutes) / sizeof(kRoutes[0]);
+static_assert(pgn_routes_unique(kRoutes), "PGN registered twice in kRoutes");
+static constexpr PgnDispatch<kN> kTable(kRoutes);
+
+__attribute__((noinline)) static int linear_index(uint32_t pgn) {
+  for (size_t i = 0; i < kN; i++)
+    if (kRoutes[i].pgn == pgn) return (int)i;
+  return -1;
+}
+
+int main() {
+  static_assert(kN >= 50, "the benchmark wants 50+ routes");
+  for (size_t i = 0; i < kN; i++) {
+    CHECK_MSG(kTable.index_of(kRoutes[i].pgn) == (int)i, "pgn %u", kRoutes[i].pgn);
+    CHECK(kTable.find(kRoutes[i].pgn) == &kTable.route(i));
+  }
+  size_t hits = 0;
+  for (uint32_t pgn = 0; pgn < 0x40000; pgn++) {
+    int i = kTable.index_of(pgn);
+    if (i >= 0) { hits++; CHECK_MSG(kRoutes[i].pgn == pgn, "pgn %u matched route %d", pgn, i); }
+  }
+  CHECK_MSG(hits == kN, "%zu of %zu routes found in the PGN space", hits, kN);
+
+  // Decoders are reached through the table
+  for (size_t i = 0; i < kN; i++) kTable.find(kRoutes[i].pgn)->decode(0, nullptr, 0);
+  for (size_t i = 0; i < kN; i++) CHECK_MSG(g_decoded[i] == 1, "route %zu decoded %u times", i, g_decoded[i]);
+
+  // Bus-like mix: 3 of 4 frames are routed, the rest are PGNs we ignore
+  std::vector<uint32_t> mix(1 << 16);
+  srand(5);
+  for (auto& p : mix) p = rand() % 4 ? kRoutes[rand() % kN].pgn : 0x1F000 + rand() % 0x1000;
+  int sum = 0;
+  double hash_ns = bench_ns([&] { for (uint32_t p : mix) sum += kTable.index_of(p); }, mix.size());
+  keep(sum);
+  int sum2 = 0;
+  double lin_ns = bench_ns([&] { for (uint32_t p : mix) sum2 += linear_index(p); }, mix.size());
+  keep(sum2);
+  CHECK(sum == sum2);
+  printf("pgn lookup, %zu routes: hash %.2f ns  linear %.2f ns  (%.1fx)\n", kN, hash_ns, lin_ns, lin_ns / hash_ns);
+  return test_result();
+}
@@ -0,0 +1,46 @@
+// rotate90_rgb565 against a per-pixel reference at odd sizes and strides,
+// then both timed on a full landscape stripe.
+#include "test_util.h"
+#include "rotate_rgb565.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+__attribute__((noinline)) static void rotate_ref(const uint16_t* src, int w, int h, int ss, uint16_t* dst, int ds) {
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) dst[(size_t)(w - 1 - x) * ds + y] = src[(size_t)y * ss + x];
+}
+
+static void check_size(int w, int h, int src_pad, int dst_pad) {
+  int ss = w + src_pad, ds = h + dst_pad;
+  std::vector<uint16_t> src((size_t)ss * h);
+  for (auto& p : src) p = (uint16_t)rand();
+  // Padding columns in dst must stay untouched: fill both with a sentinel
+  std::vector<uint16_t> got((size_t)ds * w, 0xDEAD), want((size_t)ds * w, 0xDEAD);
+  rotate90_rgb565(src.data(), w, h, ss, got.data(), ds);
+  rotate_ref(src.data(), w, h, ss, want.data(), ds);
+  CHECK_MSG(got == want, "w=%d h=%d src_pad=%d dst_pad=%d", w, h, src_pad, dst_pad);
+}
+
+int main() {
+  srand(1);
+  static const int sizes[] = { 1, 2, 3, 7, 31, 32, 33, 63, 65, 97, 129 };
+  for (int w : sizes)
+    for (int h : sizes) {
+      check_size(w, h, 0, 0);
+      check_size(w, h, 5, 3);
+    }
+  check_size(1280, 40, 0, 0);   // DISPLAY_HW_ROTATE stripe
+  check_size(1280, 23, 0, 777); // odd stripe into the 800-wide framebuffer
+
+  // One 1280 x 40 stripe into an 800 x 1280 framebuffer, as rotate_flush does
+  const int W = 1280, H = 40, FB_W = 800;
+  std::vector<uint16_t> src((size_t)W * H), fb((size_t)FB_W * W);
+  for (auto& p : src) p = (uint16_t)rand();
+  double px = (double)W * H;
+  double kernel = bench_ns([&] { rotate90_rgb565(src.data(), W, H, W, fb.data(), FB_W); keep(fb[0]); }, px, 20);
+  double ref = bench_ns([&] { rotate_ref(src.data(), W, H, W, fb.data(), FB_W); keep(fb[0]); }, px, 20);
+  printf("rotate 1280x40 -> fb stride 800: tiled %.2f ns/px, reference %.2f ns/px (%.1fx)\n",
+         kernel, ref, ref / kernel);
+  return test_result();
+}
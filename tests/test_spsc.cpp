@@ -0,0 +1,124 @@
+// SpscRing under a real producer and consumer thread: every item arrives
+// once, in order and untorn; refused pushes match overflows(); high_water()
+// stays within capacity. Ends with a push/pop throughput line.
+#include "test_util.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+
+// Multi-word payload, the size of a CAN frame record, so a torn copy shows
+struct Item {
+  uint32_t seq;
+  uint32_t data[3];
+  uint32_t sum;
+};
+
+static Item make_item(uint32_t seq) {
+  Item it;
+  it.seq = seq;
+  for (int i = 0; i < 3; i++) it.data[i] = seq * 2654435761u + i;
+  it.sum = it.seq ^ it.data[0] ^ it.data[1] ^ it.data[2];
+  return it;
+}
+
+static bool item_ok(const Item& it) {
+  return it.sum == (it.seq ^ it.data[0] ^ it.data[1] ^ it.data[2]) && it.data[0] == it.seq * 2654435761u;
+}
+
+// Producer retries until each push succeeds: nothing may be lost.
+template <size_t N>
+static void lossless(uint32_t count) {
+  static SpscRing<Item, N> r;
+  std::thread prod([&] {
+    for (uint32_t i = 0; i < count;)
+      if (r.push(make_item(i))) i++;
+      else std::this_thread::yield();   // matters on a single-core runner
+  });
+  uint32_t want = 0, bad = 0;
+  while (want < count) {
+    Item it;
+    if (!r.pop(it)) { std::this_thread::yield(); continue; }
+    if (it.seq != want || !item_ok(it)) bad++;
+    want++;
+  }
+  prod.join();
+  Item it;
+  CHECK_MSG(bad == 0, "N=%zu: %u out-of-order or torn items", N, bad);
+  CHECK_MSG(!r.pop(it), "N=%zu: ring not empty at the end", N);
+  CHECK(r.size() == 0);
+  CHECK_MSG(r.high_water() >= 1 && r.high_water() <= N, "N=%zu high_water=%u", N, r.high_water());
+}
+
+// Producer drops on a full ring, as can_bus does: the consumer sees a strictly
+// increasing subsequence and received + overflows == pushed.
+template <size_t N>
+static void lossy(uint32_t count) {
+  static SpscRing<Item, N> r;
+  std::atomic<bool> done{false};
+  uint32_t refused = 0;
+  std::thread prod([&] {
+    for (uint32_t i = 0; i < count; i++)
+      if (!r.push(make_item(i))) refused++;
+    done.store(true, std::memory_order_release);
+  });
+  uint32_t got = 0, bad = 0;
+  int64_t last = -1;
+  for (;;) {
+    Item it;
+    if (r.pop(it)) {
+      if ((int64_t)it.seq <= last || !item_ok(it)) bad++;
+      last = it.seq;
+      got++;
+      continue;
+    }
+    if (done.load(std::memory_order_acquire) && r.size() == 0) break;
+    std::this_thread::yield();
+  }
+  prod.join();
+  CHECK_MSG(bad == 0, "N=%zu: %u out-of-order or torn items", N, bad);
+  CHECK_MSG(refused == r.overflows(), "N=%zu refused=%u overflows=%u", N, refused, r.overflows());
+  CHECK_MSG(got + refused == count, "N=%zu got=%u refused=%u count=%u", N, got, refused, count);
+  CHECK(r.high_water() <= N);
+}
+
+static void single_thread_edges() {
+  SpscRing<uint32_t, 4> r;
+  uint32_t v;
+  CHECK(!r.pop(v));
+  for (uint32_t i = 0; i < 4; i++) CHECK(r.push(i));
+  CHECK(!r.push(99));
+  CHECK(r.overflows() == 1 && r.high_water() == 4 && r.size() == 4);
+  // Run the free-running indices many times round the mask
+  for (uint32_t i = 0; i < 100000; i++) {
+    CHECK(r.pop(v) && v == i);
+    CHECK(r.push(i + 4));
+  }
+  CHECK(r.size() == 4);
+}
+
+int main() {
+  single_thread_edges();
+  lossless<2>(200000);
+  lossless<256>(2000000);
+  lossy<2>(200000);
+  lossy<64>(2000000);
+
+  static SpscRing<Item, 256> r;
+  const uint32_t M = 4000000;
+  double ns = bench_ns([&] {
+    std::thread prod([&] {
+      for (uint32_t i = 0; i < M;)
+        if (r.push(make_item(i))) i++;
+        else std::this_thread::yield();
+    });
+    uint32_t n = 0;
+    Item it;
+    while (n < M)
+      if (r.pop(it)) { keep(it); n++; }
+      else std::this_thread::yield();
+    prod.join();
+  }, M, 3);
+  printf("spsc 256 x %zu B, two threads: %.1f ns/item\n", sizeof(Item), ns);
+  return test_result();
+}
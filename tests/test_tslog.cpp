@@ -0,0 +1,112 @@
+// .tsl codec: bit-exact round trip (specials included) with blocks sealed
+// every SDLOG_TSL_BLOCK_SAMPLES samples, as sdlog does, corrupt-block
+// rejection, the default rounding against the CSV's 3 decimals, and the size
+// against the CSV lines for rollup-style data.
+#include "test_util.h"
+#include "config.h"
+#include "tslog_codec.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+struct Encoded {
+  std::vector<uint8_t> bytes;
+  size_t blocks = 0;
+};
+
+static void seal(TslEncoder& e, Encoded& out) {
+  size_t n = tsl_enc_seal(e);
+  out.bytes.insert(out.bytes.end(), e.block, e.block + n);
+  out.blocks += n > 0;
+  tsl_enc_reset(e);
+}
+
+// Mirrors sdlog_append: seal when full or at SDLOG_TSL_BLOCK_SAMPLES
+static Encoded encode(const std::vector<uint32_t>& t, const std::vector<float>& v) {
+  Encoded out;
+  static TslEncoder e;
+  tsl_enc_reset(e);
+  for (size_t i = 0; i < t.size(); i++) {
+    if (!tsl_enc_add(e, t[i], v[i])) {
+      seal(e, out);
+      CHECK(tsl_enc_add(e, t[i], v[i]));
+    }
+    if (e.count >= SDLOG_TSL_BLOCK_SAMPLES) seal(e, out);
+  }
+  seal(e, out);
+  return out;
+}
+
+static void check_round_trip(const std::vector<uint32_t>& t, const std::vector<float>& v, const Encoded& enc,
+                             const char* what) {
+  static uint32_t T[TSL_BLOCK_BYTES * 8];
+  static float V[TSL_BLOCK_BYTES * 8];
+  size_t pos = 0, k = 0, bad = 0;
+  while (pos < enc.bytes.size()) {
+    size_t len = tsl_block_check(enc.bytes.data() + pos, enc.bytes.size() - pos);
+    if (!len) { CHECK_MSG(false, "%s: bad block at %zu", what, pos); return; }
+    uint16_t n = tsl_block_decode(enc.bytes.data() + pos, T, V, (uint16_t)(sizeof(T) / sizeof(T[0])));
+    for (uint16_t i = 0; i < n && k < t.size(); i++, k++)
+      bad += T[i] != t[k] || memcmp(&V[i], &v[k], sizeof(float)) != 0;
+    pos += len;
+  }
+  CHECK_MSG(k == t.size(), "%s: decoded %zu of %zu samples", what, k, t.size());
+  CHECK_MSG(bad == 0, "%s: %zu samples differ", what, bad);
+}
+
+static size_t csv_bytes(const std::vector<uint32_t>& t, const std::vector<float>& v) {
+  size_t n = 0;
+  char line[32];
+  for (size_t i = 0; i < t.size(); i++) n += snprintf(line, sizeof(line), "%lu,%.3f\n", (unsigned long)t[i], v[i]);
+  return n;
+}
+
+int main() {
+  srand(11);
+  // Rollup means: a slowly drifting battery voltage averaged over jittered
+  // 1 Hz samples, one bucket per 3.5 s, with a gap and a few special values
+  std::vector<uint32_t> t;
+  std::vector<float> raw;
+  uint32_t ms = 1000;
+  for (int i = 0; i < 20000; i++) {
+    ms += 3500 + rand() % 40;
+    if (i == 5000) ms += 100000000;
+    float sum = 0;
+    for (int k = 0; k < 4; k++) sum += 52.0f + 0.8f * sinf(i * 0.002f) + (rand() % 200 - 100) * 0.001f;
+    float v = sum / 4;
+    if (i == 7000) v = -0.0f;
+    if (i == 7001) v = INFINITY;
+    if (i == 7002) v = NAN;
+    t.push_back(ms);
+    raw.push_back(v);
+  }
+  size_t csv = csv_bytes(t, raw);
+
+  for (int bits : { 23, SDLOG_TSL_MANTISSA_BITS }) {
+    std::vector<float> v(raw);
+    float max_err = 0;
+    for (float& x : v) {
+      float q = tsl_quantize(x, (uint8_t)bits);
+      if (isfinite(x)) max_err = fmaxf(max_err, fabsf(q - x));
+      x = q;
+    }
+    Encoded enc = encode(t, v);
+    char what[32];
+    snprintf(what, sizeof(what), "%d-bit mantissa", bits);
+    check_round_trip(t, v, enc, what);
+    printf("tsl %-15s %zu samples in %zu blocks: %.2f B/sample, %.2fx smaller than CSV\n", what, t.size(),
+           enc.blocks, (double)enc.bytes.size() / t.size(), (double)csv / enc.bytes.size());
+    if (bits == 23) {
+      // Lossless: at least 2x on noisy means
+      CHECK_MSG(csv >= 2 * enc.bytes.size(), "lossless ratio %.2f", (double)csv / enc.bytes.size());
+      enc.bytes[TSL_HEADER_BYTES + 3] ^= 0x10;
+      CHECK(tsl_block_check(enc.bytes.data(), enc.bytes.size()) == 0);
+    } else {
+      // Default: no coarser than "%.3f" and at least 5x smaller than CSV
+      CHECK_MSG(max_err <= 0.0005f, "rounding error %g", max_err);
+      CHECK_MSG(csv >= 5 * enc.bytes.size(), "default ratio %.2f", (double)csv / enc.bytes.size());
+    }
+  }
+  return test_result();
+}
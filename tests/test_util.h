@@ -0,0 +1,51 @@
+#pragma once
+// Minimal host test helpers. A failed CHECK prints its location and the test
+// keeps going; main() returns test_result() so ctest sees the failure.
+#include <chrono>
+#include <stdio.h>
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+  do {                                                                           \
+    if (!(cond)) {                                                               \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);   \
+      g_failures++;                                                              \
+    }                                                                            \
+  } while (0)
+
+// CHECK with a printf-style note, e.g. CHECK_MSG(a == b, "i=%d", i)
+#define CHECK_MSG(cond, ...)                                                     \
+  do {                                                                           \
+    if (!(cond)) {                                                               \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond);   \
+      fprintf(stderr, __VA_ARGS__);                                              \
+      fputc('\n', stderr);                                                       \
+      g_failures++;                                                              \
+    }                                                                            \
+  } while (0)
+
+static inline int test_result() {
+  if (g_failures) fprintf(stderr, "%d check(s) failed\n", g_failures);
+  else printf("all checks passed\n");
+  return g_failures ? 1 : 0;
+}
+
+// Best-of-`reps` wall time of fn() in nanoseconds, divided by `per`
+// (the number of items fn processes), for benchmark lines.
+template <class F>
+static double bench_ns(F&& fn, double per = 1, int reps = 5) {
+  double best = 1e300;
+  for (int r = 0; r < reps; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    if (ns < best) best = ns;
+  }
+  return best / per;
+}
+
+// Keeps the optimizer from dropping a benchmark's result.
+template <class T>
+static inline void keep(const T& v) { asm volatile("" : : "g"(&v) : "memory"); }
@@ -0,0 +1,79 @@
+#include "host_display.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static int s_w, s_h;
+static std::vector<uint16_t> s_fb;
+static std::vector<lv_color_t> s_buf1, s_buf2;
+static lv_disp_draw_buf_t s_draw_buf;
+static lv_disp_drv_t s_drv;
+static std::vector<HostFrame> s_frames;
+static uint32_t s_flushes;
+static uint32_t s_last_px;
+static bool s_frame_done;
+
+static void flush_cb(lv_disp_drv_t* drv, const lv_area_t* a, lv_color_t* px) {
+  int w = a->x2 - a->x1 + 1;
+  for (int y = a->y1; y <= a->y2; y++, px += w)
+    memcpy(&s_fb[(size_t)y * s_w + a->x1], px, (size_t)w * sizeof(uint16_t));
+  s_flushes++;
+  lv_disp_flush_ready(drv);
+}
+
+static void monitor_cb(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px) {
+  (void)drv; (void)time_ms;
+  s_last_px = px;
+  s_frame_done = true;
+}
+
+// Times LVGL's refresh timer; monitor_cb only fires when something was drawn.
+static void timed_refr_timer(lv_timer_t* t) {
+  s_flushes = 0;
+  s_frame_done = false;
+  auto t0 = std::chrono::steady_clock::now();
+  _lv_disp_refr_timer(t);
+  auto t1 = std::chrono::steady_clock::now();
+  if (s_frame_done && s_flushes)
+    s_frames.push_back({ std::chrono::duration<double, std::micro>(t1 - t0).count(), s_last_px, s_flushes });
+}
+
+lv_disp_t* host_display_init(int hor_res, int ver_res, int stripe_lines) {
+  s_w = hor_res; s_h = ver_res;
+  s_fb.assign((size_t)s_w * s_h, 0);
+  // Same pixel budget as the firmware's stripe buffers (800 px wide panel)
+  size_t n = (size_t)800 * stripe_lines;
+  s_buf1.resize(n);
+  s_buf2.resize(n);
+  lv_disp_draw_buf_init(&s_draw_buf, s_buf1.data(), s_buf2.data(), n);
+  lv_disp_drv_init(&s_drv);
+  s_drv.hor_res = hor_res;
+  s_drv.ver_res = ver_res;
+  s_drv.draw_buf = &s_draw_buf;
+  s_drv.flush_cb = flush_cb;
+  s_drv.monitor_cb = monitor_cb;
+  lv_disp_t* disp = lv_disp_drv_register(&s_drv);
+  lv_timer_t* refr = _lv_disp_get_refr_timer(disp);
+  if (refr) refr->timer_cb = timed_refr_timer;
+  return disp;
+}
+
+std::vector<HostFrame> host_display_take_frames() {
+  std::vector<HostFrame> out;
+  out.swap(s_frames);
+  return out;
+}
+
+const uint16_t* host_display_framebuffer() { return s_fb.data(); }
+
+bool host_display_save_ppm(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P6\n%d %d\n255\n", s_w, s_h);
+  for (uint16_t p : s_fb) {
+    uint8_t rgb[3] = { (uint8_t)((p >> 11) << 3), (uint8_t)(((p >> 5) & 0x3F) << 2), (uint8_t)((p & 0x1F) << 3) };
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
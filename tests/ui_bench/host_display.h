@@ -0,0 +1,20 @@
+#pragma once
+// Memory-only LVGL display for host benchmarks. LVGL renders into stripe
+// buffers the size the firmware uses (800 x STRIPE_LINES pixels) and the flush
+// copies each area into a plain framebuffer, then signals ready at once.
+#include <lvgl.h>
+#include <stdint.h>
+#include <vector>
+
+struct HostFrame {
+  double   render_us;   // whole refresh: layout, draw and flushes
+  uint32_t px;          // pixels LVGL redrew (sum of invalidated areas)
+  uint32_t flushes;
+};
+
+lv_disp_t* host_display_init(int hor_res, int ver_res, int stripe_lines);
+// Frames completed since the last call.
+std::vector<HostFrame> host_display_take_frames();
+const uint16_t* host_display_framebuffer();
+// Writes the framebuffer as a binary PPM.
+bool host_display_save_ppm(const char* path);
@@ -0,0 +1,25 @@
+// LVGL 8.3 configuration for the host UI benchmark. Anything not set here
+// takes LVGL's default (lv_conf_internal.h).
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH          16
+#define LV_COLOR_16_SWAP        0
+#define LV_MEM_CUSTOM           1     // malloc/free
+#define LV_TICK_CUSTOM          0     // the benchmark drives lv_tick_inc()
+#define LV_DISP_DEF_REFR_PERIOD 16
+#define LV_INDEV_DEF_READ_PERIOD 15
+#define LV_DPI_DEF              130
+#define LV_USE_LOG              0
+#define LV_USE_PERF_MONITOR     0
+#define LV_USE_MEM_MONITOR      0
+#define LV_USE_FONT_COMPRESSED  1     // the Orbitron units are RLE-compressed
+
+// ui.cpp falls back to these when the Orbitron units are missing
+#define LV_FONT_MONTSERRAT_14   1
+#define LV_FONT_MONTSERRAT_16   1
+#define LV_FONT_MONTSERRAT_20   1
+#define LV_FONT_MONTSERRAT_32   1
+#define LV_FONT_MONTSERRAT_48   1
+
+#endif
@@ -0,0 +1,197 @@
+// Headless UI benchmark: builds the real ui.cpp against LVGL 8.3 and a
+// memory-only display, replays scripted scenarios on a simulated clock and
+// reports, per scenario, frames, flushes, redrawn pixels and render time,
+// then times the history chart against ring length.
+//   ui_bench [--ppm <dir>]   also writes the last frame of each scenario
+#include <lvgl.h>
+#include "Arduino.h"
+#include "host_display.h"
+#include "series_chart.h"
+#include "signal_store.h"
+#include "ui.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#if ORIENTATION_MODE == 1 || ORIENTATION_MODE == 2
+static const int SCREEN_W = 1280, SCREEN_H = 800;
+#else
+static const int SCREEN_W = 800, SCREEN_H = 1280;
+#endif
+static const int STRIPE_LINES = 40;   // display_driver.cpp default
+static const uint32_t STEP_MS = 4;    // simulated time per loop pass
+
+static uint32_t g_sim_ms = 1;
+static const char* g_ppm_dir = nullptr;
+
+// One render-task pass: advance time, pull signals, run LVGL timers.
+static void step() {
+  lv_tick_inc(STEP_MS);
+  g_sim_ms += STEP_MS;
+  host_set_millis(g_sim_ms);
+  ui_tick();
+  lv_timer_handler();
+}
+
+static void run_ms(uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += STEP_MS) step();
+}
+
+static void report(const char* name, uint32_t sim_ms) {
+  std::vector<HostFrame> f = host_display_take_frames();
+  std::vector<double> us;
+  uint64_t px = 0;
+  uint32_t flushes = 0;
+  for (const HostFrame& h : f) { us.push_back(h.render_us); px += h.px; flushes += h.flushes; }
+  std::sort(us.begin(), us.end());
+  double total = 0;
+  for (double u : us) total += u;
+  auto pct = [&](double p) { return us.empty() ? 0.0 : us[std::min(us.size() - 1, (size_t)(p * us.size()))]; };
+  printf("%-16s %7.2f %6zu %7u %9.2f %9.0f %8.0f %8.0f %8.0f %7.2f\n", name, sim_ms / 1000.0, f.size(), flushes,
+         px / 1e6, f.empty() ? 0.0 : (double)px / f.size(), us.empty() ? 0.0 : total / us.size(), pct(0.95),
+         us.empty() ? 0.0 : us.back(), sim_ms ? total / 1000.0 / (sim_ms / 1000.0) : 0.0);
+  if (g_ppm_dir) host_display_save_ppm((std::string(g_ppm_dir) + "/" + name + ".ppm").c_str());
+}
+
+struct Scenario {
+  const char* name;
+  uint32_t (*run)();   // returns simulated ms
+};
+
+static uint32_t sc_idle() {
+  run_ms(1000);
+  return 1000;
+}
+
+// Battery, wind, RPM and power updating at 10 Hz, as on a busy bus
+static uint32_t sc_values_10hz() {
+  const uint32_t dur = 10000;
+  for (uint32_t t = 0; t < dur; t += 100) {
+    float s = t / 1000.0f;
+    signal_set(SIG_BATT_V, 52.0f + 0.8f * sinf(s * 0.7f));
+    signal_set(SIG_WIND_SPEED, 7.5f + 2.0f * sinf(s * 1.3f));
+    signal_set(SIG_WIND_ANGLE, 0.6f + 0.3f * sinf(s * 0.4f));
+    signal_set(SIG_RPM, 1200 + 40 * sinf(s * 2.1f));
+    signal_set(SIG_POWER_KW, 18.0f + 3.0f * sinf(s * 0.9f));
+    run_ms(100);
+  }
+  return dur;
+}
+
+static uint32_t sc_swipes() {
+  const uint32_t each = 800;   // covers the scroll animation
+  ui_next_page(); run_ms(each);
+  ui_next_page(); run_ms(each);
+  ui_prev_page(); run_ms(each);
+  ui_prev_page(); run_ms(each);
+  return 4 * each;
+}
+
+static uint32_t sc_night_mode() {
+  for (int i = 0; i < 6; i++) { ui_set_night_mode(i % 2 == 0); run_ms(200); }
+  return 6 * 200;
+}
+
+static uint32_t sc_battery_overlay() {
+  for (int i = 0; i < 3; i++) {
+    ui_open_battery_detail();  run_ms(300);
+    ui_close_battery_detail(); run_ms(300);
+  }
+  return 3 * 600;
+}
+
+// Battery history chart alone on a screen, at the size ui.cpp gives it: one
+// new bucket per frame into rings of growing length. Frame cost should stay
+// flat as the ring grows (decimation is O(points), drawing O(columns)).
+static std::vector<float> g_ring_v, g_ring_mn, g_ring_mx;
+static std::vector<uint16_t> g_ring_n;
+
+static void ring_push(SeriesRuntime& s, uint32_t i) {
+  float v = 52.0f + 0.6f * sinf(i * 0.01f) + 0.05f * sinf(i * 0.37f);
+  s.values[s.head] = v;
+  s.mins[s.head] = v - 0.04f;
+  s.maxs[s.head] = v + 0.04f;
+  s.counts[s.head] = 6;
+  s.head = (s.head + 1) % s.cfg.points;
+  s.last_store = g_sim_ms;
+}
+
+static void chart_scenario(bool strip, uint32_t points) {
+  SeriesRuntime s = {};
+  s.cfg = { "bench", points, 3500 };
+  g_ring_v.assign(points, NAN); g_ring_mn.assign(points, NAN); g_ring_mx.assign(points, NAN);
+  g_ring_n.assign(points, 0);
+  s.values = g_ring_v.data(); s.mins = g_ring_mn.data(); s.maxs = g_ring_mx.data(); s.counts = g_ring_n.data();
+  uint32_t i = 0;
+  for (; i < points; i++) ring_push(s, i);
+
+  lv_obj_t* prev = lv_scr_act();
+  lv_obj_t* scr = lv_obj_create(nullptr);
+  lv_obj_t* chart = series_chart_create(scr);
+  lv_obj_set_pos(chart, 48, 114);
+  lv_obj_set_size(chart, SCREEN_W - 96, SCREEN_H - 162);
+  series_chart_set_strip(chart, strip);
+  series_chart_set_series(chart, &s);
+  lv_scr_load(scr);
+  run_ms(100);
+  host_display_take_frames();
+
+  const int buckets = 200;
+  double refresh_us = 0;
+  for (int n = 0; n < buckets; n++, i++) {
+    ring_push(s, i);
+    auto t0 = std::chrono::steady_clock::now();
+    series_chart_refresh(chart);
+    refresh_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    run_ms(20);
+  }
+  char name[24];
+  snprintf(name, sizeof(name), "chart_%s_%u", strip ? "strip" : "col", (unsigned)points);
+  report(name, buckets * 20);
+  printf("%-16s refresh %.1f us/bucket\n", "", refresh_us / buckets);
+
+  lv_scr_load(prev);
+  lv_obj_del(scr);
+  run_ms(50);
+  host_display_take_frames();
+}
+
+static const Scenario kScenarios[] = {
+  { "idle",            sc_idle },
+  { "values_10hz",     sc_values_10hz },
+  { "swipes",          sc_swipes },
+  { "night_mode",      sc_night_mode },
+  { "battery_overlay", sc_battery_overlay },
+};
+
+int main(int argc, char** argv) {
+  for (int i = 1; i + 1 < argc; i++)
+    if (!strcmp(argv[i], "--ppm")) g_ppm_dir = argv[++i];
+
+  host_set_millis(g_sim_ms);
+  lv_init();
+  host_display_init(SCREEN_W, SCREEN_H, STRIPE_LINES);
+
+  printf("%-16s %7s %6s %7s %9s %9s %8s %8s %8s %7s\n", "scenario", "sim_s", "frames", "flushes",
+         "Mpx", "px/frame", "mean_us", "p95_us", "max_us", "cpu_ms/s");
+  ui_build();
+  run_ms(100);
+  report("build", 100);
+  for (const Scenario& s : kScenarios) {
+    uint32_t ms = s.run();
+    report(s.name, ms);
+  }
+
+  for (bool strip : { false, true })
+    for (uint32_t points : { 256u, 1024u, 4096u }) chart_scenario(strip, points);
+
+  // Sanity: something was drawn
+  const uint16_t* fb = host_display_framebuffer();
+  bool drawn = false;
+  for (size_t i = 0; i < (size_t)SCREEN_W * SCREEN_H && !drawn; i++) drawn = fb[i] != 0;
+  if (!drawn) { fprintf(stderr, "framebuffer is empty\n"); return 1; }
+  return 0;
+}
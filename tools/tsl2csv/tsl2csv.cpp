@@ -0,0 +1,34 @@
+// Host-side converter for the SD card's .tsl logs.
+//   g++ -O2 -o tsl2csv tsl2csv.cpp ../../tslog_codec.cpp
+//   ./tsl2csv battery_v_1h.tsl > battery_v_1h.csv
+// Corrupt or truncated blocks are skipped; the reader resynchronises on the
+// next block magic and reports how many bytes it had to skip on stderr.
+#include "../../tslog_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+int main(int argc, char** argv) {
+  if (argc != 2) { fprintf(stderr, "usage: %s <file.tsl>\n", argv[0]); return 2; }
+  FILE* f = fopen(argv[1], "rb");
+  if (!f) { perror(argv[1]); return 1; }
+  std::vector<uint8_t> buf;
+  uint8_t chunk[65536];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+  fclose(f);
+
+  static uint32_t t[0x10000];
+  static float v[0x10000];
+  size_t pos = 0, skipped = 0, blocks = 0, samples = 0;
+  printf("ms,value\n");
+  while (pos < buf.size()) {
+    size_t len = tsl_block_check(buf.data() + pos, buf.size() - pos);
+    if (!len) { pos++; skipped++; continue; }
+    uint16_t got = tsl_block_decode(buf.data() + pos, t, v, 0xFFFF);
+    for (uint16_t i = 0; i < got; i++) printf("%lu,%.3f\n", (unsigned long)t[i], v[i]);
+    pos += len; blocks++; samples += got;
+  }
+  fprintf(stderr, "%zu blocks, %zu samples, %zu bytes skipped\n", blocks, samples, skipped);
+  return 0;
+}
@@ -4,6 +4,8 @@
 #include "lvgl_indev_compat.h"
 #include "config.h"
 #include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 
 #if __has_include("pins_config.h")
   #include "pins_config.h"
@@ -28,12 +30,79 @@ static lv_indev_t    *s_indev = nullptr;
 static bool           s_draw_dot = false;
 static lv_obj_t      *s_dot = nullptr;
 
+// Raw controller samples from the touch task to indev_read_cb.
+struct TouchSample { uint16_t x, y; bool pressed; };
+static QueueHandle_t  s_queue = nullptr;
+static TaskHandle_t   s_task = nullptr;
+static TouchStats     s_stats = {};
+static volatile bool  s_ready = false;   // controller is up (touch_hw_init finished)
+// Task notified (eSetBits) when a sample is queued; while set, the indev read
+// timer is paused between touches and resumed by touch_indev_wake().
+static TaskHandle_t volatile s_waker = nullptr;
+static uint32_t       s_wake_bits = 0;
+static lv_timer_t    *s_read_timer = nullptr;
+
+static void IRAM_ATTR on_touch_int() {
+  s_stats.irqs++;
+  BaseType_t woken = pdFALSE;
+  if (s_task) vTaskNotifyGiveFromISR(s_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+static void queue_sample(const TouchSample &smp) {
+  if (xQueueSend(s_queue, &smp, 0) == pdTRUE) return;
+  // Full: drop the oldest so the newest state (and every release) gets through.
+  TouchSample old;
+  xQueueReceive(s_queue, &old, 0);
+  xQueueSend(s_queue, &smp, 0);
+  s_stats.dropped++;
+}
+
+// Idle: sleeps until TP_INT, so an untouched panel costs no I2C traffic.
+// Pressed: also re-reads every TOUCH_RELEASE_POLL_MS, because the controller
+// may not raise INT for the report that says the finger is gone.
+static void touch_task(void *) {
+  bool pressed = false;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pressed ? pdMS_TO_TICKS(TOUCH_RELEASE_POLL_MS) : portMAX_DELAY);
+    TouchSample smp = {};
+    smp.pressed = s_touch->getTouch(&smp.x, &smp.y);
+    s_stats.reads++;
+    if (smp.pressed || pressed) {
+      queue_sample(smp);
+      TaskHandle_t w = s_waker;
+      if (w) xTaskNotify(w, s_wake_bits, eSetBits);
+    }
+    pressed = smp.pressed;
+  }
+}
+
 static void indev_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data) {
   (void)drv;
   static uint16_t last_x = 0, last_y = 0;
+  static bool last_pressed = false;
   bool pressed = false;
   uint16_t rx=0, ry=0;
-  if (s_touch) pressed = s_touch->getTouch(&rx, &ry);
+  if (s_queue) {
+    TouchSample smp;
+    if (xQueueReceive(s_queue, &smp, 0) == pdTRUE) {
+      last_pressed = smp.pressed;
+      if (smp.pressed) { rx = smp.x; ry = smp.y; }
+      data->continue_reading = uxQueueMessagesWaiting(s_queue) > 0;
+    } else if (last_pressed) {
+      // No new report: the finger is still where it was
+      data->state = LV_INDEV_STATE_PRESSED;
+      data->point.x = last_x;
+      data->point.y = last_y;
+      return;
+    }
+    pressed = last_pressed;
+    // Released and nothing pending: sleep until the next sample wakes us
+    if (!pressed && s_waker && s_read_timer && !data->continue_reading) lv_timer_pause(s_read_timer);
+  } else if (s_ready) {
+    pressed = s_touch->getTouch(&rx, &ry);
+    s_stats.reads++;
+  }
 
   uint16_t x = rx, y = ry;
 #if TOUCH_SWAP_XY
@@ -79,13 +148,27 @@ static void indev_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data) {
   }
 }
 
-lv_indev_t* touch_init_and_register(void) {
-  if (s_indev) return s_indev;
-
+void touch_hw_init(void) {
+  if (s_touch) return;
   s_touch = new gsl3680_touch(TP_I2C_SDA, TP_I2C_SCL, TP_RST, TP_INT);
-  s_touch->begin();
+#if TOUCH_USE_INT
+  s_queue = xQueueCreate(TOUCH_QUEUE_LEN, sizeof(TouchSample));
+  if (s_queue && xTaskCreatePinnedToCore(touch_task, "touch", TOUCH_TASK_STACK, nullptr,
+                                         TOUCH_TASK_PRIO, &s_task, TOUCH_TASK_CORE) != pdPASS) {
+    vQueueDelete(s_queue);
+    s_queue = nullptr;
+  }
+  if (!s_queue) Serial.println("[touch] task failed; polling from indev_read_cb");
+#endif
+  // The task only reads after begin(), once the first INT wakes it
+  s_touch->begin(s_queue ? on_touch_int : nullptr);
   s_touch->set_rotation(1); // base rotation; mapping fixes in config.h
+  s_ready = true;
+  Serial.println("[touch] GSL3680 initialized.");
+}
 
+lv_indev_t* touch_register_indev(void) {
+  if (s_indev) return s_indev;
   static lv_indev_drv_t drv;
   lv_indev_drv_init(&drv);
   drv.type = LV_INDEV_TYPE_POINTER;
@@ -96,9 +179,31 @@ lv_indev_t* touch_init_and_register(void) {
   s_indev = lv_indev_drv_register(&drv);
 
   lvgl_set_indev_read_period(s_indev, 15);
+  s_read_timer = lvgl_indev_get_timer(s_indev, &lv_indev_get_read_timer);
 
-  Serial.println("[touch] GSL3680 initialized and LVGL v8 indev registered.");
+  Serial.println("[touch] LVGL v8 indev registered.");
   return s_indev;
 }
 
-void touch_debug_overlay_enable(bool enable) { s_draw_dot = enable; }
+lv_indev_t* touch_init_and_register(void) {
+  touch_hw_init();
+  return touch_register_indev();
+}
+
+void touch_set_waker(TaskHandle_t task, uint32_t bits) {
+  s_wake_bits = bits;
+  s_waker = task;
+}
+
+void touch_indev_wake(void) {
+  if (!s_read_timer) return;
+  lv_timer_resume(s_read_timer);
+  lv_timer_ready(s_read_timer);
+}
+
+void touch_debug_overlay_enable(bool enable) {
+  s_draw_dot = enable;
+  if (!enable && s_dot) lv_obj_set_style_opa(s_dot, LV_OPA_0, 0);
+}
+
+TouchStats touch_get_stats(void) { return s_stats; }
@@ -1,10 +1,29 @@
 #pragma once
 #include <lvgl.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
+typedef struct {
+  uint32_t irqs;      // TP_INT edges
+  uint32_t reads;     // controller reads (I2C + GSL algorithm)
+  uint32_t dropped;   // samples pushed out of a full queue
+} TouchStats;
+
+// Controller bring-up (I2C, firmware load, touch task); no LVGL calls, so it
+// may run on another task while the display starts.
+void touch_hw_init(void);
+// LVGL side; reports "released" until touch_hw_init() has finished.
+lv_indev_t* touch_register_indev(void);
 lv_indev_t* touch_init_and_register(void);
+// Event-driven input: `task` gets `bits` (eSetBits) whenever the touch task
+// queues a sample, and must then call touch_indev_wake() from the LVGL task.
+// Until then the read timer stays paused while the panel is untouched.
+void touch_set_waker(TaskHandle_t task, uint32_t bits);
+void touch_indev_wake(void);
 void touch_debug_overlay_enable(bool enable);
+TouchStats touch_get_stats(void);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,179 @@
+#include "tslog_codec.h"
+#include <string.h>
+
+static const uint8_t kMagic[4] = { 'T', 'S', 'L', '1' };
+
+static void put_u16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put_u32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+static uint16_t get_u16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t float_bits(float v) { uint32_t b; memcpy(&b, &v, 4); return b; }
+static float bits_float(uint32_t b) { float v; memcpy(&v, &b, 4); return v; }
+
+uint32_t tsl_crc32(uint32_t crc, const uint8_t* p, size_t n) {
+  static const uint32_t t[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    crc = (crc >> 4) ^ t[crc & 15];
+    crc = (crc >> 4) ^ t[crc & 15];
+  }
+  return ~crc;
+}
+
+float tsl_quantize(float v, uint8_t mantissa_bits) {
+  if (mantissa_bits >= 23) return v;
+  uint32_t b = float_bits(v);
+  if (((b >> 23) & 0xFF) == 0xFF) return v;   // inf / nan
+  uint32_t drop = 23 - mantissa_bits;
+  b += 1u << (drop - 1);                      // round half up; a carry bumps the exponent
+  b &= ~((1u << drop) - 1);
+  return bits_float(b);
+}
+
+// ---- encoder ----
+
+static void put_bits(TslEncoder& e, uint32_t v, uint8_t n) {
+  uint8_t* payload = e.block + TSL_HEADER_BYTES;
+  while (n--) {
+    if ((v >> n) & 1) payload[e.bitpos >> 3] |= 0x80 >> (e.bitpos & 7);
+    e.bitpos++;
+  }
+}
+
+void tsl_enc_reset(TslEncoder& e) {
+  memset(e.block, 0, sizeof(e.block));
+  e.bitpos = 0; e.count = 0;
+  e.last_t = 0; e.last_delta = 0; e.last_bits = 0;
+  e.lead = 0xFF; e.trail = 0;
+}
+
+bool tsl_enc_add(TslEncoder& e, uint32_t t_ms, float v) {
+  uint32_t bits = float_bits(v);
+  if (e.count == 0) {
+    put_u32(e.block + 8, t_ms);
+    put_u32(e.block + 12, bits);
+    e.last_t = t_ms; e.last_delta = 0; e.last_bits = bits; e.lead = 0xFF;
+    e.count = 1;
+    return true;
+  }
+  if (e.count == 0xFFFF) return false;
+
+  // Work out both encodings first so a sample that does not fit leaves no trace.
+  uint32_t delta = t_ms - e.last_t;
+  int32_t  dod   = (int32_t)(delta - (uint32_t)e.last_delta);
+  uint8_t  t_cost;
+  if (dod == 0)                        t_cost = 1;
+  else if (dod >= -63 && dod <= 64)     t_cost = 2 + 7;
+  else if (dod >= -255 && dod <= 256)   t_cost = 3 + 9;
+  else if (dod >= -2047 && dod <= 2048) t_cost = 4 + 12;
+  else                                  t_cost = 4 + 32;
+
+  uint32_t x = bits ^ e.last_bits;
+  uint8_t lead = 0, trail = 0, v_cost;
+  bool reuse = false;
+  if (x == 0) {
+    v_cost = 1;
+  } else {
+    lead  = (uint8_t)__builtin_clz(x);
+    trail = (uint8_t)__builtin_ctz(x);
+    if (lead > 31) lead = 31;
+    reuse = e.lead != 0xFF && lead >= e.lead && trail >= e.trail;
+    v_cost = reuse ? 2 + (32 - e.lead - e.trail) : 2 + 5 + 6 + (32 - lead - trail);
+  }
+  if (e.bitpos + t_cost + v_cost > TSL_MAX_PAYLOAD * 8) return false;
+
+  if (dod == 0)                         put_bits(e, 0b0, 1);
+  else if (t_cost == 2 + 7)           { put_bits(e, 0b10, 2);   put_bits(e, (uint32_t)(dod + 63), 7); }
+  else if (t_cost == 3 + 9)           { put_bits(e, 0b110, 3);  put_bits(e, (uint32_t)(dod + 255), 9); }
+  else if (t_cost == 4 + 12)          { put_bits(e, 0b1110, 4); put_bits(e, (uint32_t)(dod + 2047), 12); }
+  else                                { put_bits(e, 0b1111, 4); put_bits(e, (uint32_t)dod, 32); }
+
+  if (x == 0) {
+    put_bits(e, 0b0, 1);
+  } else if (reuse) {
+    put_bits(e, 0b10, 2);
+    put_bits(e, x >> e.trail, 32 - e.lead - e.trail);
+  } else {
+    uint8_t len = 32 - lead - trail;
+    put_bits(e, 0b11, 2);
+    put_bits(e, lead, 5);
+    put_bits(e, len, 6);
+    put_bits(e, x >> trail, len);
+    e.lead = lead; e.trail = trail;
+  }
+
+  e.last_t = t_ms; e.last_delta = (int32_t)delta; e.last_bits = bits;
+  e.count++;
+  return true;
+}
+
+size_t tsl_enc_seal(TslEncoder& e) {
+  if (e.count == 0) return 0;
+  uint16_t payload = (uint16_t)((e.bitpos + 7) >> 3);
+  memcpy(e.block, kMagic, 4);
+  put_u16(e.block + 4, e.count);
+  put_u16(e.block + 6, payload);
+  uint32_t crc = tsl_crc32(0, e.block, 16);
+  crc = tsl_crc32(crc, e.block + TSL_HEADER_BYTES, payload);
+  put_u32(e.block + 16, crc);
+  return TSL_HEADER_BYTES + payload;
+}
+
+// ---- decoder ----
+
+struct BitReader { const uint8_t* p; uint32_t pos, end; };
+
+static uint32_t get_bits(BitReader& r, uint8_t n) {
+  uint32_t v = 0;
+  while (n--) {
+    uint32_t bit = r.pos < r.end ? (r.p[r.pos >> 3] >> (7 - (r.pos & 7))) & 1 : 0;
+    v = (v << 1) | bit;
+    r.pos++;
+  }
+  return v;
+}
+
+size_t tsl_block_check(const uint8_t* p, size_t avail) {
+  if (avail < TSL_HEADER_BYTES || memcmp(p, kMagic, 4) != 0) return 0;
+  uint16_t count = get_u16(p + 4), payload = get_u16(p + 6);
+  if (count == 0 || payload > TSL_MAX_PAYLOAD || TSL_HEADER_BYTES + (size_t)payload > avail) return 0;
+  uint32_t crc = tsl_crc32(0, p, 16);
+  crc = tsl_crc32(crc, p + TSL_HEADER_BYTES, payload);
+  return crc == get_u32(p + 16) ? TSL_HEADER_BYTES + payload : 0;
+}
+
+uint16_t tsl_block_decode(const uint8_t* p, uint32_t* t_ms, float* v, uint16_t max) {
+  uint16_t count = get_u16(p + 4);
+  BitReader r = { p + TSL_HEADER_BYTES, 0, (uint32_t)get_u16(p + 6) * 8 };
+  uint32_t t = get_u32(p + 8), bits = get_u32(p + 12), delta = 0;
+  uint8_t lead = 0, trail = 0;
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < count && n < max; i++) {
+    if (i > 0) {
+      int32_t dod;
+      if (!get_bits(r, 1))      dod = 0;
+      else if (!get_bits(r, 1)) dod = (int32_t)get_bits(r, 7) - 63;
+      else if (!get_bits(r, 1)) dod = (int32_t)get_bits(r, 9) - 255;
+      else if (!get_bits(r, 1)) dod = (int32_t)get_bits(r, 12) - 2047;
+      else                      dod = (int32_t)get_bits(r, 32);
+      delta += (uint32_t)dod;
+      t += delta;
+
+      if (get_bits(r, 1)) {
+        if (get_bits(r, 1)) { lead = get_bits(r, 5); uint8_t len = get_bits(r, 6); trail = 32 - lead - len; }
+        bits ^= get_bits(r, 32 - lead - trail) << trail;
+      }
+    }
+    t_ms[n] = t;
+    v[n] = bits_float(bits);
+    n++;
+  }
+  return n;
+}
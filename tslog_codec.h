@@ -0,0 +1,49 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary time-series log (.tsl). A file is a sequence of self-describing
+// blocks, each at most TSL_BLOCK_BYTES:
+//
+//   0  'T' 'S' 'L' '1'
+//   4  u16 sample count
+//   6  u16 payload bytes
+//   8  u32 t0 (ms)            first sample, stored verbatim
+//   12 u32 v0 (IEEE-754 bits)
+//   16 u32 CRC-32 of bytes 0..15 and the payload
+//   20 payload, MSB-first bit stream
+//
+// Timestamps are delta-of-delta coded and values XOR coded against the
+// previous sample (Gorilla, Pelkonen et al. 2015). All integers little-endian.
+#define TSL_BLOCK_BYTES  512
+#define TSL_HEADER_BYTES 20
+#define TSL_MAX_PAYLOAD  (TSL_BLOCK_BYTES - TSL_HEADER_BYTES)
+
+struct TslEncoder {
+  uint8_t  block[TSL_BLOCK_BYTES];
+  uint32_t bitpos;       // write position in the payload
+  uint16_t count;
+  uint32_t last_t;
+  int32_t  last_delta;
+  uint32_t last_bits;
+  uint8_t  lead, trail;  // XOR window of the previous value; lead 0xFF = none yet
+};
+
+void tsl_enc_reset(TslEncoder& e);
+// Appends one sample. Returns false, leaving the block untouched, when it does
+// not fit; seal the block, reset and add again.
+bool tsl_enc_add(TslEncoder& e, uint32_t t_ms, float v);
+// Fills in the header. Returns the block length (0 if the block is empty);
+// the bytes are e.block[0..len).
+size_t tsl_enc_seal(TslEncoder& e);
+
+// Length of the valid block at p, or 0 if p holds no intact block.
+size_t tsl_block_check(const uint8_t* p, size_t avail);
+// Decodes a block that passed tsl_block_check. Returns the samples written.
+uint16_t tsl_block_decode(const uint8_t* p, uint32_t* t_ms, float* v, uint16_t max);
+
+// Rounds v to `mantissa_bits` significant mantissa bits (23 = lossless). Fewer
+// bits leave trailing zeros in the XOR and compress much better.
+float tsl_quantize(float v, uint8_t mantissa_bits);
+
+uint32_t tsl_crc32(uint32_t crc, const uint8_t* p, size_t n);
@@ -1,5 +1,11 @@
 #include "ui.h"
 #include "config.h"
+#include "series_chart.h"
+#include "signal_store.h"
+#include "fmt_fixed.h"
+#include "glyph_cache.h"
+#include <string.h>
+#include <stdio.h>
 
 #if ORIENTATION_MODE==1 || ORIENTATION_MODE==2
 static const int SCREEN_W=1280, SCREEN_H=800;
@@ -41,6 +47,9 @@ static lv_obj_t* ap_close_btn;
 
 static lv_obj_t *rpm_val, *power_val, *batt_v_val;
 static lv_obj_t *wind_spd_val, *wind_ang_val;
+static lv_obj_t *batt_chart, *batt_range, *batt_tier_sel;
+static const SeriesRuntime* batt_tiers;
+static uint8_t batt_tier_count;
 
 static inline lv_color_t HEXC(uint32_t hex) { return lv_color_hex(hex); }
 
@@ -72,7 +81,7 @@ static void apply_styles() {
 
   lv_style_init(&st_val_lg);
 #ifdef HAVE_ORBITRON
-  lv_style_set_text_font(&st_val_lg, &orbitron_48_900);
+  lv_style_set_text_font(&st_val_lg, glyph_cache_wrap(&orbitron_48_900));
 #else
   lv_style_set_text_font(&st_val_lg, &lv_font_montserrat_48);
 #endif
@@ -80,7 +89,7 @@ static void apply_styles() {
 
   lv_style_init(&st_val_md);
 #ifdef HAVE_ORBITRON
-  lv_style_set_text_font(&st_val_md, &orbitron_32_800);
+  lv_style_set_text_font(&st_val_md, glyph_cache_wrap(&orbitron_32_800));
 #else
   lv_style_set_text_font(&st_val_md, &lv_font_montserrat_32);
 #endif
@@ -150,7 +159,26 @@ static lv_obj_t* build_page_battery(lv_obj_t* parent) {
 
   auto card = make_tile(page, 24, 24, SCREEN_W-48, SCREEN_H-48);
   mk_label(card, "Battery voltage", &st_label, 24, 18);
-  mk_label(card, "(1h / 6h / 24h series active; SD logging on)", &st_label, 24, 60);
+  batt_range = mk_label(card, "no history yet", &st_label, 24, 50);
+
+  static const char* tier_map[] = { "1h", "6h", "24h", "" };
+  batt_tier_sel = lv_btnmatrix_create(card);
+  lv_btnmatrix_set_map(batt_tier_sel, tier_map);
+  lv_btnmatrix_set_btn_ctrl_all(batt_tier_sel, LV_BTNMATRIX_CTRL_CHECKABLE);
+  lv_btnmatrix_set_one_checked(batt_tier_sel, true);
+  lv_btnmatrix_set_btn_ctrl(batt_tier_sel, 0, LV_BTNMATRIX_CTRL_CHECKED);
+  lv_obj_set_size(batt_tier_sel, 300, 56);
+  lv_obj_set_pos(batt_tier_sel, SCREEN_W-48-24-300, 12);
+  lv_obj_add_event_cb(batt_tier_sel, [](lv_event_t* e){
+    uint16_t i = lv_btnmatrix_get_selected_btn(batt_tier_sel);
+    if (batt_tiers && i < batt_tier_count) series_chart_set_series(batt_chart, &batt_tiers[i]);
+  }, LV_EVENT_VALUE_CHANGED, nullptr);
+
+  batt_chart = series_chart_create(card);
+  lv_obj_set_pos(batt_chart, 24, 90);
+  lv_obj_set_size(batt_chart, SCREEN_W-48-48, SCREEN_H-48-90-24);
+  lv_obj_set_style_line_color(batt_chart, HEXC(CLR_GREEN), 0);
+  series_chart_set_strip(batt_chart, true);
   return page;
 }
 
@@ -213,16 +241,16 @@ static void on_touch(lv_event_t* e) {
   if (code == LV_EVENT_PRESSED) {
     lv_indev_t* indev = lv_indev_get_act();
     lv_indev_get_point(indev, &touch_start);
-    touch_start_ms = millis();
+    touch_start_ms = lv_tick_get();
   } else if (code == LV_EVENT_RELEASED) {
     lv_indev_t* indev = lv_indev_get_act();
     lv_point_t now; lv_indev_get_point(indev, &now);
     int16_t dx = now.x - touch_start.x;
     int16_t dy = now.y - touch_start.y;
-    uint32_t dt = millis() - touch_start_ms;
+    uint32_t dt = lv_tick_elaps(touch_start_ms);
 
     const int SWIPE = 60;
-    if (abs(dx) > abs(dy) && abs(dx) > SWIPE) {
+    if (LV_ABS(dx) > LV_ABS(dy) && LV_ABS(dx) > SWIPE) {
       if (dx < 0) ui_next_page();
       else ui_prev_page();
     } else if (dy > SWIPE && dt < 1200) {
@@ -274,22 +302,76 @@ lv_obj_t* ui_build() {
   return root;
 }
 
+// Value labels point at these buffers (lv_label_set_text_static), so an update
+// is a format into a stack buffer, a compare and, only if the text changed,
+// a copy and invalidate; no heap traffic.
+static char rpm_txt[16], power_txt[16], batt_v_txt[16], wind_spd_txt[16], wind_ang_txt[20];
+
+static void set_value_text(lv_obj_t* l, char* buf, size_t cap, const char* txt) {
+  if (!l || strcmp(buf, txt) == 0) return;
+  strlcpy(buf, txt, cap);
+  lv_label_set_text_static(l, buf);
+}
+
 void ui_update_rpm(uint16_t rpm) {
-  if (rpm_val) { char buf[16]; snprintf(buf, sizeof(buf), "%u", (unsigned)rpm); lv_label_set_text(rpm_val, buf); }
+  char t[16]; fmt_uint(t, rpm); set_value_text(rpm_val, rpm_txt, sizeof(rpm_txt), t);
 }
 void ui_update_power_kw(float kw) {
-  if (power_val) { char buf[24]; snprintf(buf, sizeof(buf), "%.1f", kw); lv_label_set_text(power_val, buf); }
+  char t[16]; fmt_fixed(t, kw, 1); set_value_text(power_val, power_txt, sizeof(power_txt), t);
 }
 void ui_update_batt_v(float v) {
-  if (batt_v_val) { char buf[24]; snprintf(buf, sizeof(buf), "%.1f", v); lv_label_set_text(batt_v_val, buf); }
+  char t[16]; fmt_fixed(t, v, 1); set_value_text(batt_v_val, batt_v_txt, sizeof(batt_v_txt), t);
 }
 void ui_update_wind(float speed_ms, float angle_rad) {
-  if (wind_spd_val) { char b1[24]; snprintf(b1, sizeof(b1), "%.1f", speed_ms); lv_label_set_text(wind_spd_val, b1); }
-  if (wind_ang_val) { float deg = angle_rad * 57.2957795f; char b2[24]; snprintf(b2, sizeof(b2), "%.0f°", deg); lv_label_set_text(wind_ang_val, b2); }
+  char t[20];
+  fmt_fixed(t, speed_ms, 1); set_value_text(wind_spd_val, wind_spd_txt, sizeof(wind_spd_txt), t);
+  int n = fmt_fixed(t, angle_rad * 57.2957795f, 0);
+  memcpy(t + n, "°", sizeof("°"));
+  set_value_text(wind_ang_val, wind_ang_txt, sizeof(wind_ang_txt), t);
 }
 
 void ui_open_battery_detail() { lv_obj_clear_flag(batt_detail, LV_OBJ_FLAG_HIDDEN); }
 void ui_close_battery_detail(){ lv_obj_add_flag(batt_detail,   LV_OBJ_FLAG_HIDDEN); }
 void ui_ap_open()  { lv_obj_clear_flag(ap_overlay, LV_OBJ_FLAG_HIDDEN); }
 void ui_ap_close() { lv_obj_add_flag(ap_overlay,   LV_OBJ_FLAG_HIDDEN); }
-void ui_tick() {}
+void ui_bind_battery_history(const SeriesRuntime* tiers, uint8_t count) {
+  batt_tiers = tiers;
+  batt_tier_count = count;
+  uint16_t i = lv_btnmatrix_get_selected_btn(batt_tier_sel);
+  if (tiers && count) series_chart_set_series(batt_chart, &tiers[i < count ? i : 0]);
+}
+
+// True once per signal write; the value is the latest one, however many
+// frames arrived since the previous UI frame.
+static bool signal_fresh(SignalId id, float* v) {
+  static uint32_t seen[SIG_COUNT];
+  if (signal_seq(id) == seen[id]) return false;
+  SignalSample s;
+  if (!signal_get(id, &s)) return false;
+  seen[id] = s.seq;
+  *v = s.value;
+  return true;
+}
+
+void ui_tick() {
+  float v, a;
+  if (signal_fresh(SIG_RPM, &v))      ui_update_rpm((uint16_t)v);
+  if (signal_fresh(SIG_POWER_KW, &v)) ui_update_power_kw(v);
+  if (signal_fresh(SIG_BATT_V, &v))   ui_update_batt_v(v);
+  bool spd = signal_fresh(SIG_WIND_SPEED, &v);
+  bool ang = signal_fresh(SIG_WIND_ANGLE, &a);
+  if (spd || ang) {
+    SignalSample s;
+    if (!spd) v = signal_get(SIG_WIND_SPEED, &s) ? s.value : 0;
+    if (!ang) a = signal_get(SIG_WIND_ANGLE, &s) ? s.value : 0;
+    ui_update_wind(v, a);
+  }
+
+  if (batt_chart && series_chart_refresh(batt_chart)) {
+    float lo, hi; char buf[48];
+    if (series_chart_get_range(batt_chart, &lo, &hi)) snprintf(buf, sizeof(buf), "%.2f - %.2f V", lo, hi);
+    else snprintf(buf, sizeof(buf), "no history yet");
+    // Only when the range moved; setting the text invalidates the label
+    if (strcmp(buf, lv_label_get_text(batt_range))) lv_label_set_text(batt_range, buf);
+  }
+}
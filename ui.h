@@ -1,7 +1,8 @@
 #pragma once
 #include <lvgl.h>
-#include <Arduino.h>
+#include <stdint.h>
 #include "config.h"
+struct SeriesRuntime;
 lv_obj_t* ui_build();
 void ui_set_night_mode(bool enabled);
 void ui_update_rpm(uint16_t rpm);
@@ -14,4 +15,7 @@ void ui_ap_open();
 void ui_ap_close();
 void ui_next_page();
 void ui_prev_page();
+// History tiers shown on the battery page, finest first (e.g. 1h / 6h / 24h).
+void ui_bind_battery_history(const SeriesRuntime* tiers, uint8_t count);
+// Once per LVGL frame: pulls changed values from the signal store.
 void ui_tick();